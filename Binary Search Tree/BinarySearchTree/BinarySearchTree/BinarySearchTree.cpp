@@ -6,10 +6,25 @@
 // Description : Lab 5-2 Binary Search Tree
 //============================================================================
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <set>
 #include <time.h>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
 
 #include "CSVparser.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -36,17 +51,33 @@ struct Node {
     Bid bid;
     Node *left;
     Node *right;
+    Node *parent; // lets iterators step to the next node without a stack
+    int height; // levels in the subtree rooted here, a leaf is 1
+    int size; // nodes in the subtree rooted here, for order statistics
+
+    // links, height and size in the amount index of an indexed tree
+    Node *amountLeft;
+    Node *amountRight;
+    int amountHeight;
+    int amountSize;
 
     // default constructor
     Node() {
         left = nullptr;
         right = nullptr;
+        parent = nullptr;
+        height = 1;
+        size = 1;
+        amountLeft = nullptr;
+        amountRight = nullptr;
+        amountHeight = 1;
+        amountSize = 1;
     }
 
     // initialize with a bid
     Node(Bid aBid) :
             Node() {
-        bid = aBid;
+        bid = move(aBid);
     }
 };
 
@@ -57,27 +88,136 @@ struct Node {
 /**
  * Define a class containing data members and methods to
  * implement a binary search tree
+ *
+ * A balanced tree is kept as an AVL tree: after each insert or remove
+ * the nodes on the changed path are rotated until no node's subtrees
+ * differ in height by more than one, so the height stays under
+ * 1.44 log2(n) even when bids arrive in sorted runs.
+ *
+ * A tree with secondary indexes also orders its nodes by (amount,
+ * bidId) and by (fund, amount, bidId), updated on every insert and
+ * remove. The amount index is a second AVL tree threaded through the
+ * nodes' amount links, with subtree sizes so it answers ranks by
+ * amount; the fund index is an ordered set of node pointers. Nodes
+ * stay put until removed (removal relinks nodes rather than copying
+ * bids), so no bid is stored twice.
  */
 class BinarySearchTree {
 
 private:
     Node* root;
 
-    void addNode(Node* node, Bid bid);
+    // nodes come from slabs instead of one heap allocation each
+    NodePool<Node> pool;
+
+    // rebalance after every insert and remove
+    bool balanced = false;
+
+    // links from the root walked by addNode and removeNode, kept on the
+    // heap (and reused) so a degenerate tree can't overflow the stack
+    vector<Node**> path;
+
+    // orders nodes by amount, then id
+    struct AmountOrder {
+        bool operator()(const Node* a, const Node* b) const;
+    };
+
+    // orders nodes by fund, then amount, then id
+    struct FundOrder {
+        bool operator()(const Node* a, const Node* b) const;
+    };
+
+    // keep the secondary indexes below up to date
+    bool indexed = false;
+    Node* byAmount = nullptr; // root of the amount index
+    set<Node*, FundOrder> byFund;
+
+    void addNode(Bid bid);
     void inOrder(Node* node);
     void postOrder(Node* node);
     void preOrder(Node* node);
-    Node* removeNode(Node* node, string bidId);
+    void removeNode(string bidId);
+    void retrace(size_t depth);
+    void clear();
+    void indexNode(Node* node);
+    void unindexNode(Node* node);
+    int indexHeight(Node* node);
+    int indexSize(Node* node);
+    void indexUpdate(Node* node);
+    Node* indexRebalance(Node* node);
+    Node* amountInsert(Node* tree, Node* node);
+    Node* amountErase(Node* tree, Node* node);
+    void amountRange(Node* tree, double low, double high, function<void(const Bid&)>& visit);
+    int height(Node* node);
+    int size(Node* node);
+    void update(Node* node);
+    Node* rotateLeft(Node* node);
+    Node* rotateRight(Node* node);
+    Node* rebalance(Node* node);
 
 public:
+    /**
+     * A bidirectional iterator over the bids in id order. Stepping
+     * follows parent pointers, so it is O(1) amortized and needs no
+     * stack. Bids are read-only, since changing an id would break the
+     * order; inserting or removing other bids leaves it valid.
+     */
+    class Iterator {
+
+    private:
+        friend class BinarySearchTree;
+        BinarySearchTree* tree;
+        Node* node; // nullptr past the last bid
+
+        Iterator(BinarySearchTree* owner, Node* position);
+
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef Bid value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Bid* pointer;
+        typedef const Bid& reference;
+
+        Iterator();
+        reference operator*() const;
+        pointer operator->() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+    };
+
     BinarySearchTree();
+    BinarySearchTree(bool selfBalancing);
+    BinarySearchTree(bool selfBalancing, bool secondaryIndexes);
     virtual ~BinarySearchTree();
     void InOrder();
     void PostOrder();
     void PreOrder();
     void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
     void Remove(string bidId);
     Bid Search(string bidId);
+    int Height();
+    int Size();
+    bool SelfBalancing();
+    Bid Select(int rank);
+    int Rank(string bidId);
+    Bid Median();
+    Bid Percentile(double percent);
+    Bid SelectAmount(int rank);
+    Bid MedianAmount();
+    Bid PercentileAmount(double percent);
+    Iterator begin();
+    Iterator end();
+    Iterator LowerBound(string bidId);
+    Iterator UpperBound(string bidId);
+    void Range(string fromId, string toId, function<void(const Bid&)> visit);
+    void AmountRange(double low, double high, function<void(const Bid&)> visit);
+    void FundRange(string fund, function<void(const Bid&)> visit);
+    void FundRange(string fund, double low, double high, function<void(const Bid&)> visit);
 };
 
 /**
@@ -89,21 +229,315 @@ BinarySearchTree::BinarySearchTree() {
     root = nullptr;
 }
 
+/**
+ * Constructor choosing whether the tree keeps itself balanced
+ *
+ * @param selfBalancing true to rebalance after every insert and remove
+ */
+BinarySearchTree::BinarySearchTree(bool selfBalancing) : BinarySearchTree() {
+    balanced = selfBalancing;
+}
+
+/**
+ * Constructor choosing whether the tree keeps itself balanced and
+ * whether it keeps secondary indexes on amount and fund
+ *
+ * @param selfBalancing true to rebalance after every insert and remove
+ * @param secondaryIndexes true to index bids by amount and by fund
+ */
+BinarySearchTree::BinarySearchTree(bool selfBalancing, bool secondaryIndexes) : BinarySearchTree(selfBalancing) {
+    indexed = secondaryIndexes;
+}
+
 /**
  * Destructor
  */
 BinarySearchTree::~BinarySearchTree() {
-    //If the root is not null, recursively delete the tree from the root.
+    clear();
+}
+
+/**
+ * Delete every node, leaving the tree empty
+ */
+void BinarySearchTree::clear() {
+    //Destroy every node, keeping the unvisited subtrees on an explicit
+    //stack so a degenerate tree can't overflow the call stack.
+    vector<Node*> pending;
     if (root != nullptr) {
-        //delete the left and right children recursively.
-        delete root->left;
-        delete root->right;
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        Node* node = pending.back();
+        pending.pop_back();
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+        pool.Delete(node);
+    }
+    root = nullptr;
+    byAmount = nullptr;
+    byFund.clear();
+
+    //the pool then frees its slabs in one pass
+    pool.Release();
+}
+
+/**
+ * Compare two nodes by amount, then id
+ */
+bool BinarySearchTree::AmountOrder::operator()(const Node* a, const Node* b) const {
+    if (a->bid.amount != b->bid.amount) {
+        return a->bid.amount < b->bid.amount;
+    }
+    return a->bid.bidId < b->bid.bidId;
+}
+
+/**
+ * Compare two nodes by fund, then amount, then id
+ */
+bool BinarySearchTree::FundOrder::operator()(const Node* a, const Node* b) const {
+    int order = a->bid.fund.compare(b->bid.fund);
+    if (order != 0) {
+        return order < 0;
+    }
+    if (a->bid.amount != b->bid.amount) {
+        return a->bid.amount < b->bid.amount;
+    }
+    return a->bid.bidId < b->bid.bidId;
+}
+
+/**
+ * Add a new node to the secondary indexes, if the tree keeps them
+ */
+void BinarySearchTree::indexNode(Node* node) {
+    if (indexed) {
+        byAmount = amountInsert(byAmount, node);
+        byFund.insert(node);
+    }
+}
+
+/**
+ * Take a node about to be deleted out of the secondary indexes
+ */
+void BinarySearchTree::unindexNode(Node* node) {
+    if (indexed) {
+        byAmount = amountErase(byAmount, node);
+        byFund.erase(node);
+    }
+}
+
+/**
+ * Returns the height of a subtree of the amount index, 0 for an empty one
+ */
+int BinarySearchTree::indexHeight(Node* node) {
+    return node == nullptr ? 0 : node->amountHeight;
+}
+
+/**
+ * Returns the number of nodes in a subtree of the amount index
+ */
+int BinarySearchTree::indexSize(Node* node) {
+    return node == nullptr ? 0 : node->amountSize;
+}
+
+/**
+ * Recompute a node's height and size in the amount index
+ */
+void BinarySearchTree::indexUpdate(Node* node) {
+    node->amountHeight = 1 + max(indexHeight(node->amountLeft), indexHeight(node->amountRight));
+    node->amountSize = 1 + indexSize(node->amountLeft) + indexSize(node->amountRight);
+}
+
+/**
+ * Update a node of the amount index whose subtree just changed and
+ * rotate it back into AVL balance, as rebalance does for the id order
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::indexRebalance(Node* node) {
+    auto rotateLeft = [this](Node* top) {
+        Node* pivot = top->amountRight;
+        top->amountRight = pivot->amountLeft;
+        pivot->amountLeft = top;
+        indexUpdate(top);
+        indexUpdate(pivot);
+        return pivot;
+    };
+    auto rotateRight = [this](Node* top) {
+        Node* pivot = top->amountLeft;
+        top->amountLeft = pivot->amountRight;
+        pivot->amountRight = top;
+        indexUpdate(top);
+        indexUpdate(pivot);
+        return pivot;
+    };
+
+    indexUpdate(node);
+    int balance = indexHeight(node->amountLeft) - indexHeight(node->amountRight);
+    if (balance > 1) {
+        if (indexHeight(node->amountLeft->amountLeft) < indexHeight(node->amountLeft->amountRight)) {
+            node->amountLeft = rotateLeft(node->amountLeft);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (indexHeight(node->amountRight->amountRight) < indexHeight(node->amountRight->amountLeft)) {
+            node->amountRight = rotateRight(node->amountRight);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+/**
+ * Add a node to a subtree of the amount index. The index is always
+ * balanced, so recursing is only O(log n) deep.
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::amountInsert(Node* tree, Node* node) {
+    if (tree == nullptr) {
+        node->amountLeft = nullptr;
+        node->amountRight = nullptr;
+        indexUpdate(node);
+        return node;
+    }
+    if (AmountOrder()(node, tree)) {
+        tree->amountLeft = amountInsert(tree->amountLeft, node);
+    }
+    else {
+        tree->amountRight = amountInsert(tree->amountRight, node);
+    }
+    return indexRebalance(tree);
+}
+
+/**
+ * Take a node out of a subtree of the amount index. A node with two
+ * children is replaced by relinking the next node by amount into its
+ * place.
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::amountErase(Node* tree, Node* node) {
+    if (tree == nullptr) {
+        return nullptr;
+    }
+    if (tree == node) {
+        if (tree->amountLeft == nullptr) {
+            return tree->amountRight;
+        }
+        if (tree->amountRight == nullptr) {
+            return tree->amountLeft;
+        }
+        Node* next = tree->amountRight;
+        while (next->amountLeft != nullptr) {
+            next = next->amountLeft;
+        }
+        next->amountRight = amountErase(tree->amountRight, next);
+        next->amountLeft = tree->amountLeft;
+        return indexRebalance(next);
+    }
+    if (AmountOrder()(node, tree)) {
+        tree->amountLeft = amountErase(tree->amountLeft, node);
+    }
+    else {
+        tree->amountRight = amountErase(tree->amountRight, node);
+    }
+    return indexRebalance(tree);
+}
+
+/**
+ * Visit the bids in a subtree of the amount index with amounts from low
+ * to high, in order, skipping subtrees wholly outside the range
+ */
+void BinarySearchTree::amountRange(Node* tree, double low, double high, function<void(const Bid&)>& visit) {
+    if (tree == nullptr) {
+        return;
+    }
+    if (tree->bid.amount >= low) {
+        amountRange(tree->amountLeft, low, high, visit);
+    }
+    if (tree->bid.amount >= low && tree->bid.amount <= high) {
+        visit(tree->bid);
+    }
+    if (tree->bid.amount <= high) {
+        amountRange(tree->amountRight, low, high, visit);
+    }
+}
+
+/**
+ * Visit the bids with amounts from low to high inclusive, in order of
+ * amount, then id. With secondary indexes this is a range scan of the
+ * amount index, O(log n + k); without them every bid is checked.
+ *
+ * @param low The smallest amount to visit
+ * @param high The largest amount to visit
+ * @param visit Called with each bid in the range
+ */
+void BinarySearchTree::AmountRange(double low, double high, function<void(const Bid&)> visit) {
+    if (!indexed) {
+        vector<const Bid*> matches;
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (it->amount >= low && it->amount <= high) {
+                matches.push_back(&*it);
+            }
+        }
+        stable_sort(matches.begin(), matches.end(), [](const Bid* a, const Bid* b) {
+            return a->amount < b->amount;
+        });
+        for (const Bid* match : matches) {
+            visit(*match);
+        }
+        return;
+    }
+
+    amountRange(byAmount, low, high, visit);
+}
+
+/**
+ * Visit every bid in a fund, in order of amount, then id
+ *
+ * @param fund The fund to visit the bids of
+ * @param visit Called with each bid in the fund
+ */
+void BinarySearchTree::FundRange(string fund, function<void(const Bid&)> visit) {
+    FundRange(fund, -numeric_limits<double>::infinity(), numeric_limits<double>::infinity(), visit);
+}
+
+/**
+ * Visit the bids in a fund with amounts from low to high inclusive, in
+ * order of amount, then id. The fund index is ordered by fund first, so
+ * with secondary indexes this is one range scan, O(log n + k); without
+ * them every bid is checked.
+ *
+ * @param fund The fund to visit the bids of
+ * @param low The smallest amount to visit
+ * @param high The largest amount to visit
+ * @param visit Called with each bid in the range
+ */
+void BinarySearchTree::FundRange(string fund, double low, double high, function<void(const Bid&)> visit) {
+    if (!indexed) {
+        AmountRange(low, high, [&fund, &visit](const Bid& bid) {
+            if (bid.fund == fund) {
+                visit(bid);
+            }
+        });
+        return;
+    }
 
-        //delete the root node.
-        delete root;
+    Node probe;
+    probe.bid.fund = fund;
+    probe.bid.amount = low;
+    for (auto it = byFund.lower_bound(&probe);
+        it != byFund.end() && (*it)->bid.fund == fund && (*it)->bid.amount <= high; ++it) {
+        visit((*it)->bid);
     }
 }
 
+
 /**
  * Traverse the tree in order
  */
@@ -134,17 +568,99 @@ void BinarySearchTree::PreOrder() {
  * Insert a bid
  */
 void BinarySearchTree::Insert(Bid bid) {
-    //Checks to see if the tree is empty.
-    if (root == nullptr) {
-        //If the tree is empty, create a new node with the provided bid.
-        root = new Node(bid);
+    //Call addNode to find the correct place for the bid starting from
+    //the root.
+    addNode(bid);
+}
+
+/**
+ * Add many bids at once, rebuilding the tree perfectly balanced in a
+ * linear pass instead of one insert per bid. Input already in id order
+ * is used as it is; anything else is sorted first. The bids are merged
+ * with those already in the tree, keeping the first bid given for an id
+ * as Insert does. Every node is then allocated afresh, in id order, so
+ * the nodes sit next to each other in the pool's slabs, and linked so
+ * each one is the middle of its subtree's range.
+ *
+ * @param bids The bids to add
+ */
+void BinarySearchTree::BulkLoad(vector<Bid> bids) {
+    auto idLess = [](const Bid& a, const Bid& b) {
+        return a.bidId < b.bidId;
+    };
+    auto idEqual = [](const Bid& a, const Bid& b) {
+        return a.bidId == b.bidId;
+    };
+
+    //Order the new bids, a stable sort keeps the first of equal ids first
+    if (!is_sorted(bids.begin(), bids.end(), idLess)) {
+        stable_sort(bids.begin(), bids.end(), idLess);
     }
-    else {
-        //If the tree is not empty, call the addNode to find the correct place for the bid
-        //starting from the root.
-        addNode(root, bid);
+    bids.erase(unique(bids.begin(), bids.end(), idEqual), bids.end());
+
+    //Merge in the bids already in the tree, which win over new ones
+    if (root != nullptr) {
+        vector<Bid> merged;
+        merged.reserve(bids.size() + Size());
+        auto next = bids.begin();
+        for (Iterator it = begin(); it != end(); ++it) {
+            while (next != bids.end() && next->bidId < it->bidId) {
+                merged.push_back(move(*next++));
+            }
+            if (next != bids.end() && next->bidId == it->bidId) {
+                ++next;
+            }
+            merged.push_back(move(it.node->bid));
+        }
+        move(next, bids.end(), back_inserter(merged));
+        bids.swap(merged);
+    }
+
+    //Allocate the nodes in order from fresh slabs
+    clear();
+    vector<Node*> nodes;
+    nodes.reserve(bids.size());
+    for (Bid& bid : bids) {
+        nodes.push_back(pool.New(move(bid)));
+    }
+
+    //Link each range's middle node to the middles of its two halves
+    struct Span {
+        size_t begin;
+        size_t end;
+        Node* parent;
+        Node** link;
+    };
+    vector<Span> spans;
+    spans.push_back({ 0, nodes.size(), nullptr, &root });
+    while (!spans.empty()) {
+        Span span = spans.back();
+        spans.pop_back();
+        if (span.begin == span.end) {
+            *span.link = nullptr;
+            continue;
+        }
+
+        size_t middle = span.begin + (span.end - span.begin) / 2;
+        Node* node = nodes[middle];
+        node->parent = span.parent;
+        *span.link = node;
+
+        //A balanced range of n nodes is floor(log2(n)) + 1 levels high
+        node->size = (int)(span.end - span.begin);
+        node->height = 0;
+        for (size_t n = span.end - span.begin; n > 0; n /= 2) {
+            node->height++;
+        }
+
+        spans.push_back({ span.begin, middle, node, &node->left });
+        spans.push_back({ middle + 1, span.end, node, &node->right });
     }
 
+    //Index the new nodes
+    for (Node* node : nodes) {
+        indexNode(node);
+    }
 }
 
 /**
@@ -152,7 +668,7 @@ void BinarySearchTree::Insert(Bid bid) {
  */
 void BinarySearchTree::Remove(string bidId) {
     // Removing a bid from the tree
-    root = removeNode(root, bidId);
+    removeNode(bidId);
 }
 
 /**
@@ -184,168 +700,1389 @@ Bid BinarySearchTree::Search(string bidId) {
 }
 
 /**
- * Add a bid to some node (recursive)
+ * Returns the number of levels in the tree, 0 when it is empty
+ */
+int BinarySearchTree::Height() {
+    return height(root);
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+int BinarySearchTree::Size() {
+    return size(root);
+}
+
+/**
+ * Returns true when the tree rebalances after every insert and remove
+ */
+bool BinarySearchTree::SelfBalancing() {
+    return balanced;
+}
+
+/**
+ * Find the bid with a given rank in id order, in O(height) by skipping
+ * whole left subtrees by their size
  *
- * @param node Current node in tree
- * @param bid Bid to be added
+ * @param rank The number of bids with smaller ids, from 0 to Size() - 1
+ * @return the bid, or an empty bid when rank is out of range
  */
-void BinarySearchTree::addNode(Node* node, Bid bid) {
-    // If the new bid's bidId is smaller than the current node's bidId,
-    // we need to go to the left subtree.
-    if (bid.bidId < node->bid.bidId) {
-        // If there is no left child, insert the new node here
-        if (node->left == nullptr) {
-            node->left = new Node(bid);  // Create a new node and attach it as the left child
-        }
-        else {
-            // Otherwise, recurse down the left child
-            addNode(node->left, bid);
+Bid BinarySearchTree::Select(int rank) {
+    Node* current = root;
+    while (current != nullptr) {
+        int leftSize = size(current->left);
+        if (rank < leftSize) {
+            current = current->left;
         }
-    }
-    // If the new bid's bidId is larger than the current node's bidId,
-    // we need to go to the right subtree.
-    else if (bid.bidId > node->bid.bidId) {
-        // If there is no right child, insert the new node here
-        if (node->right == nullptr) {
-            node->right = new Node(bid);  // Create a new node and attach it as the right child
+        else if (rank == leftSize) {
+            return current->bid;
         }
         else {
-            // Otherwise, recurse down the right child
-            addNode(node->right, bid);
+            //skip the left subtree and this node
+            rank -= leftSize + 1;
+            current = current->right;
         }
     }
-
+    Bid bid;
+    return bid;
 }
 
-void BinarySearchTree::inOrder(Node* node) {
-    // Check if the node is not nullptr
-    if (node != nullptr) {
-        // Recurse to the left subtree first
-        inOrder(node->left);
-
-        // Output the bid details for the current node
-        cout << "Bid ID: " << node->bid.bidId << " | "
-            << "Title: " << node->bid.title << " | "
-            << "Amount: " << node->bid.amount << " | "
-            << "Fund: " << node->bid.fund << endl;
-
-        // Recurse to the right subtree
-        inOrder(node->right);
+/**
+ * Count the bids with ids smaller than bidId, in O(height); for a bid in
+ * the tree this is its position in id order, from 0
+ *
+ * @param bidId The bid id to rank, which needn't be in the tree
+ */
+int BinarySearchTree::Rank(string bidId) {
+    int rank = 0;
+    Node* current = root;
+    while (current != nullptr) {
+        if (bidId <= current->bid.bidId) {
+            current = current->left;
+        }
+        else {
+            //the left subtree and this node all come before bidId
+            rank += size(current->left) + 1;
+            current = current->right;
+        }
     }
+    return rank;
 }
-void BinarySearchTree::postOrder(Node* node) {
-    // Check if the node is not nullptr
-    if (node != nullptr) {
-        // Recurse to the left subtree
-        postOrder(node->left);
-
-        // Recurse to the right subtree
-        postOrder(node->right);
-
-        // Output the bid details for the current node
-        cout << "Bid ID: " << node->bid.bidId << " | "
-            << "Title: " << node->bid.title << " | "
-            << "Amount: " << node->bid.amount << " | "
-            << "Fund: " << node->bid.fund << endl;
-    }
 
+/**
+ * Returns the middle bid in id order, the lower one of the two middle
+ * bids when there is an even number
+ */
+Bid BinarySearchTree::Median() {
+    return Select((Size() - 1) / 2);
 }
 
-void BinarySearchTree::preOrder(Node* node) {
-    // Check if the node is not nullptr
-    if (node != nullptr) {
-        // Output the bid details for the current node
-        cout << "Bid ID: " << node->bid.bidId << " | "
-            << "Title: " << node->bid.title << " | "
-            << "Amount: " << node->bid.amount << " | "
-            << "Fund: " << node->bid.fund << endl;
-
-        // Recurse to the left subtree
-        preOrder(node->left);
-
-        // Recurse to the right subtree
-        preOrder(node->right);
-    }
+/**
+ * Returns the bid at a percentile of id order by the nearest-rank
+ * method: the first bid with at least percent of the bids at or below it
+ *
+ * @param percent From 0 to 100
+ */
+Bid BinarySearchTree::Percentile(double percent) {
+    int rank = (int)ceil(percent / 100.0 * Size()) - 1;
+    return Select(max(0, min(rank, Size() - 1)));
 }
 
 /**
- * Remove a bid from some node (recursive)
+ * Find the bid with a given rank in order of amount, then id. With
+ * secondary indexes this walks the amount index in O(log n); without
+ * them the bids are partitioned around the rank in O(n).
+ *
+ * @param rank The number of bids ordered before it, from 0 to Size() - 1
+ * @return the bid, or an empty bid when rank is out of range
  */
-Node* BinarySearchTree::removeNode(Node* node, string bidId) {
-    // If the node is nullptr, return nullptr (base case for recursion)
-    if (node == nullptr) {
-        return node;
+Bid BinarySearchTree::SelectAmount(int rank) {
+    if (!indexed) {
+        vector<const Bid*> bids;
+        for (Iterator it = begin(); it != end(); ++it) {
+            bids.push_back(&*it);
+        }
+        if (rank < 0 || rank >= (int)bids.size()) {
+            Bid bid;
+            return bid;
+        }
+        nth_element(bids.begin(), bids.begin() + rank, bids.end(), [](const Bid* a, const Bid* b) {
+            if (a->amount != b->amount) {
+                return a->amount < b->amount;
+            }
+            return a->bidId < b->bidId;
+        });
+        return *bids[rank];
     }
 
-    // If the bidId is smaller than the current node's bidId, go to the left subtree
-    if (bidId < node->bid.bidId) {
-        node->left = removeNode(node->left, bidId);
-    }
-    // If the bidId is greater than the current node's bidId, go to the right subtree
-    else if (bidId > node->bid.bidId) {
-        node->right = removeNode(node->right, bidId);
-    }
-    // If we found the node to be deleted
-    else {
-        // Case 1: Node has no children 
-        if (node->left == nullptr && node->right == nullptr) {
-            delete node; // Delete the node
-            node = nullptr; // Set the pointer to nullptr
-        }
-        // Case 2: Node has one child 
-        else if (node->left == nullptr) {
-            Node* temp = node;
-            node = node->right; // Move the node's right child up
-            delete temp; // Delete the old node
-        }
-        else if (node->right == nullptr) {
-            Node* temp = node;
-            node = node->left; // Move the node's left child up
-            delete temp; // Delete the old node
-        }
-        // Case 3: Node has two children
+    Node* current = byAmount;
+    while (current != nullptr) {
+        int leftSize = indexSize(current->amountLeft);
+        if (rank < leftSize) {
+            current = current->amountLeft;
+        }
+        else if (rank == leftSize) {
+            return current->bid;
+        }
         else {
-            // Find the minimum node in the right subtree.
-            Node* temp = node->right;
-            while (temp->left != nullptr) {
-                temp = temp->left; // Move left until the minimum node is found
-            }
-
-            // Replace the node's data with the successor's data
-            node->bid = temp->bid;
-
-            // Now delete the successor (which is in the right subtree)
-            node->right = removeNode(node->right, temp->bid.bidId);
+            rank -= leftSize + 1;
+            current = current->amountRight;
         }
     }
-
-    return node;
+    Bid bid;
+    return bid;
 }
 
-
-
-//============================================================================
-// Static methods used for testing
-//============================================================================
+/**
+ * Returns the bid with the median amount, the lower one of the two
+ * middle bids when there is an even number; ties go by id
+ */
+Bid BinarySearchTree::MedianAmount() {
+    return SelectAmount((Size() - 1) / 2);
+}
 
 /**
- * Display the bid information to the console (std::out)
+ * Returns the bid at a percentile of amount by the nearest-rank method
  *
- * @param bid struct containing the bid info
+ * @param percent From 0 to 100
  */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-            << bid.fund << endl;
-    return;
+Bid BinarySearchTree::PercentileAmount(double percent) {
+    int rank = (int)ceil(percent / 100.0 * Size()) - 1;
+    return SelectAmount(max(0, min(rank, Size() - 1)));
 }
 
 /**
- * Load a CSV file containing bids into a container
- *
- * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
+ * Returns an iterator at the bid with the smallest id
  */
-void loadBids(string csvPath, BinarySearchTree* bst) {
+BinarySearchTree::Iterator BinarySearchTree::begin() {
+    Node* node = root;
+    while (node != nullptr && node->left != nullptr) {
+        node = node->left;
+    }
+    return Iterator(this, node);
+}
+
+/**
+ * Returns an iterator just past the bid with the largest id
+ */
+BinarySearchTree::Iterator BinarySearchTree::end() {
+    return Iterator(this, nullptr);
+}
+
+/**
+ * Returns an iterator at the first bid whose id is not less than bidId
+ */
+BinarySearchTree::Iterator BinarySearchTree::LowerBound(string bidId) {
+    Node* found = nullptr;
+    Node* current = root;
+    while (current != nullptr) {
+        if (current->bid.bidId < bidId) {
+            current = current->right;
+        }
+        else {
+            //a candidate; a smaller one may still be to the left
+            found = current;
+            current = current->left;
+        }
+    }
+    return Iterator(this, found);
+}
+
+/**
+ * Returns an iterator at the first bid whose id is greater than bidId
+ */
+BinarySearchTree::Iterator BinarySearchTree::UpperBound(string bidId) {
+    Node* found = nullptr;
+    Node* current = root;
+    while (current != nullptr) {
+        if (bidId < current->bid.bidId) {
+            found = current;
+            current = current->left;
+        }
+        else {
+            current = current->right;
+        }
+    }
+    return Iterator(this, found);
+}
+
+/**
+ * Visit the bids with ids from fromId to toId inclusive, in id order, in
+ * O(log n + k) for k bids: one descent to the first, then iterator steps
+ *
+ * @param fromId The smallest id to visit
+ * @param toId The largest id to visit
+ * @param visit Called with each bid in the range
+ */
+void BinarySearchTree::Range(string fromId, string toId, function<void(const Bid&)> visit) {
+    for (Iterator it = LowerBound(fromId); it != end() && it->bidId <= toId; ++it) {
+        visit(*it);
+    }
+}
+
+/**
+ * Default constructor, an iterator at no tree's end
+ */
+BinarySearchTree::Iterator::Iterator() {
+    tree = nullptr;
+    node = nullptr;
+}
+
+/**
+ * Constructor for an iterator at a node of a tree
+ */
+BinarySearchTree::Iterator::Iterator(BinarySearchTree* owner, Node* position) {
+    tree = owner;
+    node = position;
+}
+
+/**
+ * Returns the bid the iterator is at
+ */
+BinarySearchTree::Iterator::reference BinarySearchTree::Iterator::operator*() const {
+    return node->bid;
+}
+
+/**
+ * Returns the bid the iterator is at
+ */
+BinarySearchTree::Iterator::pointer BinarySearchTree::Iterator::operator->() const {
+    return &node->bid;
+}
+
+/**
+ * Step to the next bid in id order: the leftmost node of the right
+ * subtree, or else the first ancestor reached from its left side
+ */
+BinarySearchTree::Iterator& BinarySearchTree::Iterator::operator++() {
+    if (node->right != nullptr) {
+        node = node->right;
+        while (node->left != nullptr) {
+            node = node->left;
+        }
+    }
+    else {
+        Node* child = node;
+        node = node->parent;
+        while (node != nullptr && child == node->right) {
+            child = node;
+            node = node->parent;
+        }
+    }
+    return *this;
+}
+
+/**
+ * Step to the next bid, returning where the iterator was
+ */
+BinarySearchTree::Iterator BinarySearchTree::Iterator::operator++(int) {
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+/**
+ * Step to the previous bid in id order, the mirror image of ++; from
+ * end() that is the bid with the largest id
+ */
+BinarySearchTree::Iterator& BinarySearchTree::Iterator::operator--() {
+    if (node == nullptr) {
+        node = tree->root;
+        while (node != nullptr && node->right != nullptr) {
+            node = node->right;
+        }
+    }
+    else if (node->left != nullptr) {
+        node = node->left;
+        while (node->right != nullptr) {
+            node = node->right;
+        }
+    }
+    else {
+        Node* child = node;
+        node = node->parent;
+        while (node != nullptr && child == node->left) {
+            child = node;
+            node = node->parent;
+        }
+    }
+    return *this;
+}
+
+/**
+ * Step to the previous bid, returning where the iterator was
+ */
+BinarySearchTree::Iterator BinarySearchTree::Iterator::operator--(int) {
+    Iterator previous = *this;
+    --*this;
+    return previous;
+}
+
+/**
+ * Iterators are equal when they are at the same bid, or both at the end
+ */
+bool BinarySearchTree::Iterator::operator==(const Iterator& other) const {
+    return node == other.node;
+}
+
+/**
+ * Iterators differ when they are at different bids
+ */
+bool BinarySearchTree::Iterator::operator!=(const Iterator& other) const {
+    return node != other.node;
+}
+
+/**
+ * Returns a subtree's height, 0 for an empty one
+ */
+int BinarySearchTree::height(Node* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+/**
+ * Returns the number of nodes in a subtree, 0 for an empty one
+ */
+int BinarySearchTree::size(Node* node) {
+    return node == nullptr ? 0 : node->size;
+}
+
+/**
+ * Recompute a node's height and size from its children's
+ */
+void BinarySearchTree::update(Node* node) {
+    node->height = 1 + max(height(node->left), height(node->right));
+    node->size = 1 + size(node->left) + size(node->right);
+}
+
+/**
+ * Rotate a node down to the left, lifting its right child into its place
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left != nullptr) {
+        pivot->left->parent = node;
+    }
+    pivot->left = node;
+    pivot->parent = node->parent;
+    node->parent = pivot;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+/**
+ * Rotate a node down to the right, lifting its left child into its place
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right != nullptr) {
+        pivot->right->parent = node;
+    }
+    pivot->right = node;
+    pivot->parent = node->parent;
+    node->parent = pivot;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+/**
+ * Update a node whose subtree just changed and, in a balanced tree,
+ * rotate it back into AVL balance
+ *
+ * @return the subtree's new root
+ */
+Node* BinarySearchTree::rebalance(Node* node) {
+    update(node);
+    if (!balanced) {
+        return node;
+    }
+
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) {
+        //left heavy; a right-leaning left child needs a double rotation
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        //right heavy, the mirror image
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+/**
+ * Add a bid below the root, walking down iteratively
+ *
+ * @param bid Bid to be added
+ */
+void BinarySearchTree::addNode(Bid bid) {
+    // Follow the links down from the root, remembering each one
+    path.clear();
+    Node** link = &root;
+    while (*link != nullptr) {
+        Node* node = *link;
+        path.push_back(link);
+
+        // If the new bid's bidId is smaller than the current node's bidId,
+        // we need to go to the left subtree.
+        if (bid.bidId < node->bid.bidId) {
+            link = &node->left;
+        }
+        // If the new bid's bidId is larger than the current node's bidId,
+        // we need to go to the right subtree.
+        else if (bid.bidId > node->bid.bidId) {
+            link = &node->right;
+        }
+        // A bid already in the tree is left as it is
+        else {
+            return;
+        }
+    }
+
+    // The empty link is where the new node goes, below the last node passed
+    *link = pool.New(bid);
+    (*link)->parent = path.empty() ? nullptr : *path.back();
+    indexNode(*link);
+
+    // Fix the heights (and the balance) on the way back up
+    retrace(path.size());
+}
+
+/**
+ * Fix the heights and sizes, and in a balanced tree the balance, of the
+ * nodes on path, from the deepest up. Once a node's subtree comes out
+ * with the height it had, no node above it needs rebalancing and only
+ * their sizes are brought up to date.
+ *
+ * @param depth The number of links on path to retrace
+ */
+void BinarySearchTree::retrace(size_t depth) {
+    bool settled = false;
+    while (depth > 0) {
+        Node** link = path[--depth];
+        Node* node = *link;
+        if (settled) {
+            update(node);
+            continue;
+        }
+        int before = node->height;
+        *link = rebalance(node);
+        settled = *link == node && node->height == before;
+    }
+}
+
+/**
+ * Traverse a subtree in order without recursion or a stack (Morris
+ * traversal): before going left, the rightmost node of the left subtree
+ * is threaded back to the current node so the walk can climb back, and
+ * the thread is removed on the way through. The tree is restored when
+ * the traversal ends.
+ */
+void BinarySearchTree::inOrder(Node* node) {
+    while (node != nullptr) {
+        if (node->left != nullptr) {
+            // Find the in-order predecessor of this node
+            Node* predecessor = node->left;
+            while (predecessor->right != nullptr && predecessor->right != node) {
+                predecessor = predecessor->right;
+            }
+
+            // First visit: thread it back here and go left
+            if (predecessor->right == nullptr) {
+                predecessor->right = node;
+                node = node->left;
+                continue;
+            }
+
+            // Second visit: the left subtree is done, remove the thread
+            predecessor->right = nullptr;
+        }
+
+        // Output the bid details for the current node
+        cout << "Bid ID: " << node->bid.bidId << " | "
+            << "Title: " << node->bid.title << " | "
+            << "Amount: " << node->bid.amount << " | "
+            << "Fund: " << node->bid.fund << endl;
+
+        // Continue with the right subtree (or follow a thread back up)
+        node = node->right;
+    }
+}
+
+/**
+ * Traverse a subtree in post-order, keeping the path on an explicit stack
+ */
+void BinarySearchTree::postOrder(Node* node) {
+    vector<Node*> pending;
+    Node* visited = nullptr;
+
+    while (node != nullptr || !pending.empty()) {
+        // Go as far left as possible
+        if (node != nullptr) {
+            pending.push_back(node);
+            node = node->left;
+            continue;
+        }
+
+        // Descend into the right subtree unless it was just finished
+        Node* top = pending.back();
+        if (top->right != nullptr && top->right != visited) {
+            node = top->right;
+            continue;
+        }
+
+        // Both subtrees are done, output the bid details for this node
+        cout << "Bid ID: " << top->bid.bidId << " | "
+            << "Title: " << top->bid.title << " | "
+            << "Amount: " << top->bid.amount << " | "
+            << "Fund: " << top->bid.fund << endl;
+
+        visited = top;
+        pending.pop_back();
+    }
+}
+
+/**
+ * Traverse a subtree in pre-order, keeping unvisited subtrees on an
+ * explicit stack
+ */
+void BinarySearchTree::preOrder(Node* node) {
+    vector<Node*> pending;
+    if (node != nullptr) {
+        pending.push_back(node);
+    }
+
+    while (!pending.empty()) {
+        node = pending.back();
+        pending.pop_back();
+
+        // Output the bid details for the current node
+        cout << "Bid ID: " << node->bid.bidId << " | "
+            << "Title: " << node->bid.title << " | "
+            << "Amount: " << node->bid.amount << " | "
+            << "Fund: " << node->bid.fund << endl;
+
+        // Push the right subtree first so the left one comes out first
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+    }
+}
+
+/**
+ * Remove a bid below the root, walking down iteratively. A node with
+ * two children is replaced by its in-order successor node itself, so
+ * no bid is copied and other nodes never move.
+ */
+void BinarySearchTree::removeNode(string bidId) {
+    // Follow the links down to the node, remembering each one
+    path.clear();
+    Node** link = &root;
+    while (*link != nullptr && (*link)->bid.bidId != bidId) {
+        path.push_back(link);
+        if (bidId < (*link)->bid.bidId) {
+            link = &(*link)->left;
+        }
+        else {
+            link = &(*link)->right;
+        }
+    }
+
+    // If the bid isn't in the tree there is nothing to remove
+    Node* node = *link;
+    if (node == nullptr) {
+        return;
+    }
+
+    // Case 1 and 2: Node has at most one child, which moves up
+    if (node->left == nullptr || node->right == nullptr) {
+        Node* child = node->left != nullptr ? node->left : node->right;
+        *link = child;
+        if (child != nullptr) {
+            child->parent = node->parent;
+        }
+    }
+    // Case 3: Node has two children
+    else {
+        size_t nodeDepth = path.size();
+        path.push_back(link);
+
+        // Find the minimum node in the right subtree.
+        Node** successorLink = &node->right;
+        while ((*successorLink)->left != nullptr) {
+            path.push_back(successorLink);
+            successorLink = &(*successorLink)->left;
+        }
+        Node* successor = *successorLink;
+
+        // Unhook the successor, then put it where the node was
+        *successorLink = successor->right;
+        if (successor->right != nullptr) {
+            successor->right->parent = successor->parent;
+        }
+        successor->left = node->left;
+        successor->right = node->right;
+        successor->left->parent = successor;
+        if (successor->right != nullptr) {
+            successor->right->parent = successor;
+        }
+        successor->parent = node->parent;
+        successor->height = node->height;
+        *link = successor;
+
+        // The path below now runs through the successor's right link
+        if (path.size() > nodeDepth + 1) {
+            path[nodeDepth + 1] = &successor->right;
+        }
+    }
+    unindexNode(node);
+    pool.Delete(node);
+
+    // Fix the heights (and the balance) on the way back up
+    retrace(path.size());
+}
+
+
+
+//============================================================================
+// B+ tree class definition
+//============================================================================
+
+// separator keys in an inner node; their prefixes fill four cache lines
+const int BPLUS_INNER_KEYS = 32;
+
+// bids in a leaf page
+const int BPLUS_LEAF_BIDS = 32;
+
+/**
+ * Pack the first eight bytes of a bid id into an integer, big-endian and
+ * zero padded, so comparing two prefixes orders ids the way comparing
+ * the strings does. Only ids with equal prefixes need a string compare.
+ */
+uint64_t keyPrefix(const string& bidId) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        prefix <<= 8;
+        if (i < bidId.size()) {
+            prefix |= (unsigned char)bidId[i];
+        }
+    }
+    return prefix;
+}
+
+/**
+ * Define a class storing bids in a B+ tree ordered by bid id, with the
+ * same interface as BinarySearchTree. Bids live only in leaf pages of up
+ * to BPLUS_LEAF_BIDS, linked in order for InOrder. Inner nodes hold up
+ * to BPLUS_INNER_KEYS separators, with each separator's packed prefix in
+ * a contiguous array: a search scans it with a branch-free count the
+ * compiler can vectorize, so each level costs a few adjacent cache
+ * lines rather than a pointer chase per comparison. Every node but the
+ * root stays at least half full.
+ */
+class BPlusTree {
+
+private:
+    // A leaf page: bids in order with their prefixes, linked both ways
+    struct Leaf {
+        int count = 0;
+        uint64_t prefixes[BPLUS_LEAF_BIDS];
+        Bid bids[BPLUS_LEAF_BIDS];
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+    };
+
+    // An inner node: children[i] holds the ids from keys[i - 1] up to keys[i]
+    struct Inner {
+        int count = 0;
+        uint64_t prefixes[BPLUS_INNER_KEYS];
+        string keys[BPLUS_INNER_KEYS];
+        void* children[BPLUS_INNER_KEYS + 1];
+    };
+
+    // an inner node on the path down, with the child taken
+    struct Step {
+        Inner* node;
+        int child;
+    };
+
+    void* root;
+    int size;      // bids in the tree
+    int depth;     // levels of inner nodes above the leaves
+    Leaf* first;   // leftmost leaf, where InOrder starts
+    NodePool<Leaf> leaves;
+    NodePool<Inner> inners;
+    vector<Step> path;
+
+    int childIndex(Inner* inner, const string& bidId, uint64_t prefix);
+    int leafIndex(Leaf* leaf, const string& bidId, uint64_t prefix);
+    Leaf* findLeaf(const string& bidId, uint64_t prefix);
+    void insertIntoLeaf(Leaf* leaf, int index, Bid bid);
+    void eraseFromLeaf(Leaf* leaf, int index);
+    void insertIntoInner(Inner* inner, int index, string key, void* child);
+    void eraseFromInner(Inner* inner, int index);
+    void fixLeaf(Leaf* leaf);
+    void fixInner(Inner* inner);
+
+public:
+    BPlusTree();
+    virtual ~BPlusTree();
+    void InOrder();
+    void Insert(Bid bid);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Height();
+    int Size();
+    void Range(string fromId, string toId, function<void(const Bid&)> visit);
+};
+
+/**
+ * Default constructor
+ */
+BPlusTree::BPlusTree() {
+    root = nullptr;
+    size = 0;
+    depth = 0;
+    first = nullptr;
+}
+
+/**
+ * Destructor
+ */
+BPlusTree::~BPlusTree() {
+    //Destroy the inner nodes level by level, then the leaves along
+    //their list; the pools then free their slabs.
+    vector<Inner*> level;
+    if (depth > 0) {
+        level.push_back(static_cast<Inner*>(root));
+    }
+    for (int d = 0; d < depth; ++d) {
+        vector<Inner*> below;
+        for (Inner* inner : level) {
+            if (d + 1 < depth) {
+                for (int i = 0; i <= inner->count; ++i) {
+                    below.push_back(static_cast<Inner*>(inner->children[i]));
+                }
+            }
+            inners.Delete(inner);
+        }
+        level.swap(below);
+    }
+    while (first != nullptr) {
+        Leaf* next = first->next;
+        leaves.Delete(first);
+        first = next;
+    }
+}
+
+/**
+ * Which child of an inner node may hold a bid id: the number of
+ * separators not greater than it
+ */
+int BPlusTree::childIndex(Inner* inner, const string& bidId, uint64_t prefix) {
+    int index = 0;
+    for (int i = 0; i < inner->count; ++i) {
+        index += inner->prefixes[i] < prefix;
+    }
+    while (index < inner->count && inner->prefixes[index] == prefix && inner->keys[index] <= bidId) {
+        ++index;
+    }
+    return index;
+}
+
+/**
+ * Where a bid id is or would go in a leaf: the number of bids before it
+ */
+int BPlusTree::leafIndex(Leaf* leaf, const string& bidId, uint64_t prefix) {
+    int index = 0;
+    for (int i = 0; i < leaf->count; ++i) {
+        index += leaf->prefixes[i] < prefix;
+    }
+    while (index < leaf->count && leaf->prefixes[index] == prefix && leaf->bids[index].bidId < bidId) {
+        ++index;
+    }
+    return index;
+}
+
+/**
+ * Walk down to the leaf that may hold a bid id, recording the path
+ */
+BPlusTree::Leaf* BPlusTree::findLeaf(const string& bidId, uint64_t prefix) {
+    path.clear();
+    void* node = root;
+    for (int d = 0; d < depth; ++d) {
+        Inner* inner = static_cast<Inner*>(node);
+        int child = childIndex(inner, bidId, prefix);
+        path.push_back({ inner, child });
+        node = inner->children[child];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+/**
+ * Put a bid into a leaf with room for it, shifting the later ones up
+ */
+void BPlusTree::insertIntoLeaf(Leaf* leaf, int index, Bid bid) {
+    for (int i = leaf->count; i > index; --i) {
+        leaf->prefixes[i] = leaf->prefixes[i - 1];
+        leaf->bids[i] = move(leaf->bids[i - 1]);
+    }
+    leaf->prefixes[index] = keyPrefix(bid.bidId);
+    leaf->bids[index] = move(bid);
+    leaf->count++;
+}
+
+/**
+ * Take a bid out of a leaf, shifting the later ones down
+ */
+void BPlusTree::eraseFromLeaf(Leaf* leaf, int index) {
+    for (int i = index + 1; i < leaf->count; ++i) {
+        leaf->prefixes[i - 1] = leaf->prefixes[i];
+        leaf->bids[i - 1] = move(leaf->bids[i]);
+    }
+    leaf->count--;
+    leaf->bids[leaf->count] = Bid();
+}
+
+/**
+ * Put a separator into an inner node with room for it, with the child
+ * holding the ids from that separator up
+ */
+void BPlusTree::insertIntoInner(Inner* inner, int index, string key, void* child) {
+    for (int i = inner->count; i > index; --i) {
+        inner->prefixes[i] = inner->prefixes[i - 1];
+        inner->keys[i] = move(inner->keys[i - 1]);
+        inner->children[i + 1] = inner->children[i];
+    }
+    inner->prefixes[index] = keyPrefix(key);
+    inner->keys[index] = move(key);
+    inner->children[index + 1] = child;
+    inner->count++;
+}
+
+/**
+ * Take a separator and the child to its right out of an inner node
+ */
+void BPlusTree::eraseFromInner(Inner* inner, int index) {
+    for (int i = index + 1; i < inner->count; ++i) {
+        inner->prefixes[i - 1] = inner->prefixes[i];
+        inner->keys[i - 1] = move(inner->keys[i]);
+        inner->children[i] = inner->children[i + 1];
+    }
+    inner->count--;
+    inner->keys[inner->count].clear();
+}
+
+/**
+ * Traverse the leaves in order
+ */
+void BPlusTree::InOrder() {
+    for (Leaf* leaf = first; leaf != nullptr; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; ++i) {
+            // Output the bid details
+            Bid& bid = leaf->bids[i];
+            cout << "Bid ID: " << bid.bidId << " | "
+                << "Title: " << bid.title << " | "
+                << "Amount: " << bid.amount << " | "
+                << "Fund: " << bid.fund << endl;
+        }
+    }
+}
+
+/**
+ * Insert a bid, splitting full nodes on the way back up
+ */
+void BPlusTree::Insert(Bid bid) {
+    //An empty tree starts as a single leaf
+    if (root == nullptr) {
+        first = leaves.New();
+        root = first;
+    }
+
+    uint64_t prefix = keyPrefix(bid.bidId);
+    Leaf* leaf = findLeaf(bid.bidId, prefix);
+    int index = leafIndex(leaf, bid.bidId, prefix);
+
+    //A bid already in the tree is left as it is
+    if (index < leaf->count && leaf->bids[index].bidId == bid.bidId) {
+        return;
+    }
+    size++;
+    if (leaf->count < BPLUS_LEAF_BIDS) {
+        insertIntoLeaf(leaf, index, move(bid));
+        return;
+    }
+
+    //Split a full leaf in half and link the new right half after it
+    Leaf* right = leaves.New();
+    int half = BPLUS_LEAF_BIDS / 2;
+    for (int i = half; i < leaf->count; ++i) {
+        right->prefixes[i - half] = leaf->prefixes[i];
+        right->bids[i - half] = move(leaf->bids[i]);
+        leaf->bids[i] = Bid();
+    }
+    right->count = leaf->count - half;
+    leaf->count = half;
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (leaf->next != nullptr) {
+        leaf->next->prev = right;
+    }
+    leaf->next = right;
+    if (index <= half) {
+        insertIntoLeaf(leaf, index, move(bid));
+    }
+    else {
+        insertIntoLeaf(right, index - half, move(bid));
+    }
+
+    //Add the right half's first id as a separator in the parent,
+    //splitting full inner nodes for as long as it takes
+    string key = right->bids[0].bidId;
+    void* child = right;
+    while (!path.empty()) {
+        Step step = path.back();
+        path.pop_back();
+        Inner* inner = step.node;
+        if (inner->count < BPLUS_INNER_KEYS) {
+            insertIntoInner(inner, step.child, move(key), child);
+            return;
+        }
+
+        //Lay the full node's separators and children out with the new
+        //ones, keep the first half, move the second half to a new node
+        //and pass the middle separator up
+        string keys[BPLUS_INNER_KEYS + 1];
+        void* children[BPLUS_INNER_KEYS + 2];
+        for (int i = 0, j = 0; i <= BPLUS_INNER_KEYS; ++i) {
+            keys[i] = i == step.child ? move(key) : move(inner->keys[j++]);
+        }
+        for (int i = 0, j = 0; i <= BPLUS_INNER_KEYS + 1; ++i) {
+            children[i] = i == step.child + 1 ? child : inner->children[j++];
+        }
+
+        int middle = (BPLUS_INNER_KEYS + 1) / 2;
+        Inner* sibling = inners.New();
+        inner->count = 0;
+        inner->children[0] = children[0];
+        for (int i = 0; i < middle; ++i) {
+            insertIntoInner(inner, i, move(keys[i]), children[i + 1]);
+        }
+        sibling->children[0] = children[middle + 1];
+        for (int i = middle + 1; i <= BPLUS_INNER_KEYS; ++i) {
+            insertIntoInner(sibling, i - middle - 1, move(keys[i]), children[i + 1]);
+        }
+        key = move(keys[middle]);
+        child = sibling;
+    }
+
+    //The root split, so the tree grows a level
+    Inner* top = inners.New();
+    top->children[0] = root;
+    insertIntoInner(top, 0, move(key), child);
+    root = top;
+    depth++;
+}
+
+/**
+ * Remove a bid, refilling or merging nodes left under half full
+ */
+void BPlusTree::Remove(string bidId) {
+    if (root == nullptr) {
+        return;
+    }
+
+    uint64_t prefix = keyPrefix(bidId);
+    Leaf* leaf = findLeaf(bidId, prefix);
+    int index = leafIndex(leaf, bidId, prefix);
+
+    //If the bid isn't in the tree there is nothing to remove
+    if (index == leaf->count || leaf->bids[index].bidId != bidId) {
+        return;
+    }
+    eraseFromLeaf(leaf, index);
+    size--;
+
+    //Separators needn't be ids still in the tree, so they stay as they are
+    if (leaf->count < BPLUS_LEAF_BIDS / 2) {
+        fixLeaf(leaf);
+    }
+}
+
+/**
+ * Bring a leaf back to half full from a sibling under the same parent,
+ * borrowing a bid if the sibling can spare one and merging the two
+ * otherwise
+ */
+void BPlusTree::fixLeaf(Leaf* leaf) {
+    //The root leaf may hold any number of bids, down to none
+    if (path.empty()) {
+        if (leaf->count == 0) {
+            leaves.Delete(leaf);
+            root = nullptr;
+            first = nullptr;
+        }
+        return;
+    }
+
+    Step step = path.back();
+    path.pop_back();
+    Inner* parent = step.node;
+    Leaf* left = step.child > 0 ? static_cast<Leaf*>(parent->children[step.child - 1]) : nullptr;
+    Leaf* right = step.child < parent->count ? static_cast<Leaf*>(parent->children[step.child + 1]) : nullptr;
+
+    //Borrow the left sibling's last bid
+    if (left != nullptr && left->count > BPLUS_LEAF_BIDS / 2) {
+        insertIntoLeaf(leaf, 0, move(left->bids[left->count - 1]));
+        eraseFromLeaf(left, left->count - 1);
+        parent->keys[step.child - 1] = leaf->bids[0].bidId;
+        parent->prefixes[step.child - 1] = leaf->prefixes[0];
+        return;
+    }
+
+    //Borrow the right sibling's first bid
+    if (right != nullptr && right->count > BPLUS_LEAF_BIDS / 2) {
+        insertIntoLeaf(leaf, leaf->count, move(right->bids[0]));
+        eraseFromLeaf(right, 0);
+        parent->keys[step.child] = right->bids[0].bidId;
+        parent->prefixes[step.child] = right->prefixes[0];
+        return;
+    }
+
+    //Merge with a sibling: the right one of the pair empties into the left
+    int separator = left != nullptr ? step.child - 1 : step.child;
+    if (left == nullptr) {
+        left = leaf;
+        leaf = right;
+    }
+    for (int i = 0; i < leaf->count; ++i) {
+        insertIntoLeaf(left, left->count, move(leaf->bids[i]));
+    }
+    left->next = leaf->next;
+    if (leaf->next != nullptr) {
+        leaf->next->prev = left;
+    }
+    leaves.Delete(leaf);
+    eraseFromInner(parent, separator);
+
+    fixInner(parent);
+}
+
+/**
+ * Bring an inner node back to half full after it lost a child, rotating
+ * a separator through the parent from a sibling that can spare one and
+ * merging with a sibling otherwise. The root only shrinks the tree a
+ * level when it has a single child left.
+ */
+void BPlusTree::fixInner(Inner* inner) {
+    while (!path.empty()) {
+        if (inner->count >= BPLUS_INNER_KEYS / 2) {
+            return;
+        }
+
+        Step step = path.back();
+        path.pop_back();
+        Inner* parent = step.node;
+        Inner* left = step.child > 0 ? static_cast<Inner*>(parent->children[step.child - 1]) : nullptr;
+        Inner* right = step.child < parent->count ? static_cast<Inner*>(parent->children[step.child + 1]) : nullptr;
+
+        //Rotate the left sibling's last child over through the parent
+        if (left != nullptr && left->count > BPLUS_INNER_KEYS / 2) {
+            insertIntoInner(inner, 0, move(parent->keys[step.child - 1]), inner->children[0]);
+            inner->children[0] = left->children[left->count];
+            parent->keys[step.child - 1] = move(left->keys[left->count - 1]);
+            parent->prefixes[step.child - 1] = left->prefixes[left->count - 1];
+            left->count--;
+            return;
+        }
+
+        //Rotate the right sibling's first child over through the parent
+        if (right != nullptr && right->count > BPLUS_INNER_KEYS / 2) {
+            insertIntoInner(inner, inner->count, move(parent->keys[step.child]), right->children[0]);
+            parent->keys[step.child] = move(right->keys[0]);
+            parent->prefixes[step.child] = right->prefixes[0];
+            right->children[0] = right->children[1];
+            eraseFromInner(right, 0);
+            return;
+        }
+
+        //Merge with a sibling, pulling the separator between them down
+        int separator = left != nullptr ? step.child - 1 : step.child;
+        if (left == nullptr) {
+            left = inner;
+            inner = right;
+        }
+        insertIntoInner(left, left->count, move(parent->keys[separator]), inner->children[0]);
+        for (int i = 0; i < inner->count; ++i) {
+            insertIntoInner(left, left->count, move(inner->keys[i]), inner->children[i + 1]);
+        }
+        inners.Delete(inner);
+        eraseFromInner(parent, separator);
+
+        //The parent lost a child and may need fixing in turn
+        inner = parent;
+    }
+
+    //The root only shrinks the tree a level when one child is left
+    if (inner->count == 0) {
+        root = inner->children[0];
+        inners.Delete(inner);
+        depth--;
+    }
+}
+
+/**
+ * Search for a bid
+ */
+Bid BPlusTree::Search(string bidId) {
+    if (root != nullptr) {
+        //Walk straight down; no path is needed to only read
+        uint64_t prefix = keyPrefix(bidId);
+        void* node = root;
+        for (int d = 0; d < depth; ++d) {
+            Inner* inner = static_cast<Inner*>(node);
+            node = inner->children[childIndex(inner, bidId, prefix)];
+        }
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int index = leafIndex(leaf, bidId, prefix);
+        if (index < leaf->count && leaf->bids[index].bidId == bidId) {
+            return leaf->bids[index];
+        }
+    }
+
+    //If no matching bidId was found, return a default bid.
+    Bid bid;
+    return bid;
+}
+
+/**
+ * Returns the number of levels in the tree, leaves included
+ */
+int BPlusTree::Height() {
+    return root == nullptr ? 0 : depth + 1;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+int BPlusTree::Size() {
+    return size;
+}
+
+/**
+ * Visit the bids with ids from fromId to toId inclusive, in id order:
+ * one descent to the first, then along the leaf list
+ *
+ * @param fromId The smallest id to visit
+ * @param toId The largest id to visit
+ * @param visit Called with each bid in the range
+ */
+void BPlusTree::Range(string fromId, string toId, function<void(const Bid&)> visit) {
+    if (root == nullptr) {
+        return;
+    }
+    uint64_t prefix = keyPrefix(fromId);
+    Leaf* leaf = findLeaf(fromId, prefix);
+    for (int i = leafIndex(leaf, fromId, prefix); leaf != nullptr; leaf = leaf->next, i = 0) {
+        for (; i < leaf->count; ++i) {
+            if (toId < leaf->bids[i].bidId) {
+                return;
+            }
+            visit(leaf->bids[i]);
+        }
+    }
+}
+
+//============================================================================
+// Eytzinger search index class definition
+//============================================================================
+
+// keys per cache line; a search prefetches the line holding the node's
+// descendants this many keys down, three levels ahead
+const size_t EYTZINGER_LINE_KEYS = 8;
+
+/**
+ * Hint the processor to start loading an address into cache
+ */
+inline void prefetch(const void* address) {
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    __builtin_prefetch(address);
+#endif
+}
+
+/**
+ * Returns the number of trailing one bits in a value
+ */
+inline int trailingOnes(uint64_t value) {
+    if (~value == 0) {
+        return 64;
+    }
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, ~value);
+    return (int)index;
+#else
+    return __builtin_ctzll(~value);
+#endif
+}
+
+/**
+ * Define a class holding a read-only snapshot of a BinarySearchTree for
+ * fast lookups. The bids are copied into an array in id order, and each
+ * id's packed prefix (see keyPrefix) into a second array in Eytzinger
+ * order: the root at 1, the children of k at 2k and 2k + 1, so the top
+ * levels share a few cache lines and the eight descendants three levels
+ * below k share one. A search descends with no branch but the loop,
+ * prefetching three levels ahead, then maps the slot it lands on back to
+ * the id-ordered array. Ids longer than eight bytes that share a prefix
+ * are told apart there with string compares.
+ *
+ * The snapshot doesn't follow later changes to the tree; Rebuild() it
+ * after a batch of inserts and removes. The keys are found by their
+ * offset into storage, so a copy of the index searches its own keys
+ * (though they may no longer start on a cache line).
+ */
+class EytzingerIndex {
+
+private:
+    vector<Bid> bids;          // in id order
+    vector<uint64_t> storage;  // keys, with room to align them
+    size_t keyOffset;          // storage[keyOffset + k] is key k, k from 1 to n
+    vector<uint32_t> ranks;    // ranks[k] is key k's bid in bids
+
+    size_t fill(size_t next, size_t slot);
+
+public:
+    EytzingerIndex(BinarySearchTree& tree);
+    void Rebuild(BinarySearchTree& tree);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Constructor, takes a snapshot of a tree
+ */
+EytzingerIndex::EytzingerIndex(BinarySearchTree& tree) {
+    keyOffset = 0;
+    Rebuild(tree);
+}
+
+/**
+ * Place the bids from next on in the subtree rooted at slot, in order
+ *
+ * @return the first bid not placed
+ */
+size_t EytzingerIndex::fill(size_t next, size_t slot) {
+    if (slot <= bids.size()) {
+        next = fill(next, 2 * slot);
+        storage[keyOffset + slot] = keyPrefix(bids[next].bidId);
+        ranks[slot] = (uint32_t)next++;
+        next = fill(next, 2 * slot + 1);
+    }
+    return next;
+}
+
+/**
+ * Take a fresh snapshot of a tree, dropping the old one
+ *
+ * @param tree The tree to copy the bids of
+ */
+void EytzingerIndex::Rebuild(BinarySearchTree& tree) {
+    bids.assign(tree.begin(), tree.end());
+    size_t n = bids.size();
+
+    //Line up keys[0] with a cache line so each group of eight
+    //descendants, keys[8k] to keys[8k + 7], sits in one line
+    storage.assign(n + 1 + EYTZINGER_LINE_KEYS, 0);
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+    size_t lineBytes = EYTZINGER_LINE_KEYS * sizeof(uint64_t);
+    keyOffset = (lineBytes - address % lineBytes) % lineBytes / sizeof(uint64_t);
+
+    ranks.assign(n + 1, 0);
+    fill(0, 1);
+}
+
+/**
+ * Search for a bid
+ */
+Bid EytzingerIndex::Search(string bidId) {
+    uint64_t prefix = keyPrefix(bidId);
+    size_t n = bids.size();
+    const uint64_t* keys = storage.data() + keyOffset;
+
+    //Go left at keys not below the prefix and right at smaller ones; the
+    //path taken is written in k's bits. The prefetch is clamped to the
+    //last key, since the bottom levels have no descendants to load.
+    size_t k = 1;
+    while (k <= n) {
+        prefetch(keys + min(k * EYTZINGER_LINE_KEYS, n));
+        k = 2 * k + (keys[k] < prefix);
+    }
+
+    //Drop the trailing right turns and the last left turn to get back
+    //to the first key not below the prefix (0 when there is none)
+    k >>= trailingOnes(k) + 1;
+    if (k != 0) {
+        for (size_t i = ranks[k]; i < n && keyPrefix(bids[i].bidId) == prefix; ++i) {
+            if (bids[i].bidId == bidId) {
+                return bids[i];
+            }
+        }
+    }
+
+    //If no matching bidId was found, return a default bid.
+    Bid bid;
+    return bid;
+}
+
+/**
+ * Returns the number of bids in the snapshot
+ */
+int EytzingerIndex::Size() {
+    return (int)bids.size();
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    return;
+}
+
+/**
+ * Read the bids in a CSV file
+ *
+ * @param csvPath the path to the CSV file to load
+ * @return the bids read, in file order
+ */
+vector<Bid> readBids(string csvPath) {
+    vector<Bid> bids;
+
     cout << "Loading CSV file " << csvPath << endl;
 
     // initialize the CSV Parser using the given path
@@ -372,11 +2109,45 @@ void loadBids(string csvPath, BinarySearchTree* bst) {
             //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
 
             // push this bid to the end
-            bst->Insert(bid);
+            bids.push_back(bid);
         }
     } catch (csv::Error &e) {
         std::cerr << e.what() << std::endl;
     }
+
+    return bids;
+}
+
+/**
+ * Load a CSV file containing bids into a container
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param bst the container to add the bids read to
+ */
+template <typename Tree>
+void loadBids(string csvPath, Tree* bst) {
+    for (Bid& bid : readBids(csvPath)) {
+        bst->Insert(bid);
+    }
+}
+
+/**
+ * Load a CSV file containing bids into a binary search tree. A
+ * self-balancing tree is loaded in one linear rebuild rather than an
+ * insert per bid; a plain tree gets an insert per bid, so it keeps the
+ * shape that file order gives it.
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param bst the tree to add the bids read to
+ */
+void loadBids(string csvPath, BinarySearchTree* bst) {
+    if (!bst->SelfBalancing()) {
+        for (Bid& bid : readBids(csvPath)) {
+            bst->Insert(bid);
+        }
+        return;
+    }
+    bst->BulkLoad(readBids(csvPath));
 }
 
 /**
@@ -393,32 +2164,58 @@ double strToDouble(string str, char ch) {
 }
 
 /**
- * The one and only main() method
+ * Find the bids in a fund with amounts in a range, if the tree can
+ *
+ * @return false when the tree has no fund lookups
  */
-int main(int argc, char* argv[]) {
+template <typename Tree>
+bool findByFund(Tree*, string, double, double, function<void(const Bid&)>) {
+    return false;
+}
 
-    // process command line arguments
-    string csvPath, bidKey;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        bidKey = "98223";
-        break;
-    case 3:
-        csvPath = argv[1];
-        bidKey = argv[2];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-        bidKey = "98223";
-    }
+bool findByFund(BinarySearchTree* bst, string fund, double low, double high, function<void(const Bid&)> visit) {
+    bst->FundRange(fund, low, high, visit);
+    return true;
+}
+
+/**
+ * Freeze a tree into a read-only search index and look a bid up in it,
+ * if the tree can be frozen
+ *
+ * @return false when the tree has no search index
+ */
+template <typename Tree>
+bool findInSnapshot(Tree*, string, Bid&, clock_t&) {
+    return false;
+}
+
+bool findInSnapshot(BinarySearchTree* bst, string bidId, Bid& bid, clock_t& ticks) {
+    ticks = clock();
+    EytzingerIndex index(*bst);
+    ticks = clock() - ticks;
+    cout << index.Size() << " bids frozen" << endl;
+    cout << "time: " << ticks << " clock ticks" << endl;
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+    ticks = clock();
+    bid = index.Search(bidId);
+    ticks = clock() - ticks;
+    return true;
+}
+
+/**
+ * Run the menu against one tree implementation
+ *
+ * @param bst The tree to load, display, find and remove bids in
+ * @param csvPath path to CSV file to load from
+ * @param bidKey the bid Id to use when searching the tree
+ */
+template <typename Tree>
+void runMenu(Tree* bst, string csvPath, string bidKey) {
 
     // Define a timer variable
     clock_t ticks;
 
-    // Define a binary search tree to hold all bids
-    BinarySearchTree* bst;
-    bst = new BinarySearchTree();
     Bid bid;
 
     int choice = 0;
@@ -428,6 +2225,9 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Find Bids in Range" << endl;
+        cout << "  6. Find Bids by Fund and Amount" << endl;
+        cout << "  7. Freeze Tree and Find Bid" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -442,7 +2242,8 @@ int main(int argc, char* argv[]) {
             // Complete the method call to load the bids
             loadBids(csvPath, bst);
 
-            //cout << bst->Size() << " bids read" << endl;
+            cout << bst->Size() << " bids read" << endl;
+            cout << "tree height: " << bst->Height() << endl;
 
             // Calculate elapsed time and display result
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
@@ -475,8 +2276,125 @@ int main(int argc, char* argv[]) {
         case 4:
             bst->Remove(bidKey);
             break;
+
+        case 5: {
+            string fromId, toId;
+            cout << "Enter first bid Id: ";
+            cin >> fromId;
+            cout << "Enter last bid Id: ";
+            cin >> toId;
+
+            ticks = clock();
+
+            int found = 0;
+            bst->Range(fromId, toId, [&found](const Bid& match) {
+                displayBid(match);
+                found++;
+            });
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            cout << found << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+        }
+
+        case 6: {
+            string fund, amount;
+            cout << "Enter fund: ";
+            cin >> ws;
+            getline(cin, fund);
+            cout << "Enter lowest amount: ";
+            cin >> amount;
+            double low = strToDouble(amount, '$');
+            cout << "Enter highest amount: ";
+            cin >> amount;
+            double high = strToDouble(amount, '$');
+
+            ticks = clock();
+
+            int found = 0;
+            bool supported = findByFund(bst, fund, low, high, [&found](const Bid& match) {
+                displayBid(match);
+                found++;
+            });
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (!supported) {
+                cout << "This tree can't look bids up by fund." << endl;
+                break;
+            }
+            cout << found << " bids found" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+        }
+
+        case 7:
+            if (!findInSnapshot(bst, bidKey, bid, ticks)) {
+                cout << "This tree can't be frozen." << endl;
+                break;
+            }
+
+            if (!bid.bidId.empty()) {
+                displayBid(bid);
+            } else {
+                cout << "Bid Id " << bidKey << " not found." << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
         }
     }
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional)
+ * @param arg[2] the bid Id to use when searching the tree (optional)
+ * @param arg[3] "avl" for a self-balancing tree, "indexed" for one with
+ *               indexes on amount and fund, "bplus" for a B+ tree or
+ *               "unbalanced" (the default) for a plain one (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line arguments
+    string csvPath, bidKey, treeType = "unbalanced";
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        bidKey = "98223";
+        break;
+    case 3:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        break;
+    case 4:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        treeType = argv[3];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+        bidKey = "98223";
+    }
+
+    // Define a tree to hold all bids
+    if (treeType == "bplus") {
+        BPlusTree* tree = new BPlusTree();
+        runMenu(tree, csvPath, bidKey);
+        delete tree;
+    }
+    else {
+        bool indexed = treeType == "indexed";
+        BinarySearchTree* bst = new BinarySearchTree(indexed || treeType == "avl", indexed);
+        runMenu(bst, csvPath, bidKey);
+        delete bst;
+    }
 
     cout << "Good bye." << endl;
 
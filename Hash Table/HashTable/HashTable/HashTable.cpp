@@ -15,6 +15,7 @@
 #include <time.h>
 
 #include "CSVparser.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -74,6 +75,9 @@ private:
 
     vector<Node> nodes;
 
+    // chained nodes come from slabs instead of one heap allocation each
+    NodePool<Node> pool;
+
     unsigned int tableSize = DEFAULT_SIZE;
 
     unsigned int hash(int key);
@@ -125,10 +129,11 @@ HashTable::~HashTable() {
             //Stores the current node, moves to the current node and deletes the current node.
             Node* temp = current;
             current = current->next;
-            delete temp;
+            pool.Delete(temp);
         }
 
     }
+    //the pool then frees its slabs in one pass
 }
 
 /**
@@ -182,7 +187,7 @@ void HashTable::Insert(Bid bid) {
             }
 
             //add the new bid to the end of the chain
-            current->next = new Node(bid, key);
+            current->next = pool.New(bid, key);
 
         }
 
@@ -197,7 +202,7 @@ void HashTable::Insert(Bid bid) {
         }
 
         //Add the new node to the end of the chain
-        current->next = new Node(bid, key);
+        current->next = pool.New(bid, key);
     }
 }
 
@@ -248,16 +253,24 @@ void HashTable::Remove(string bidId) {
         if (currentNode->key != UINT_MAX && currentNode->bid.bidId == bidId) {
             //bid is found and removed 
             if (lastNode == nullptr) {
-                //removing the first node in the list.
-                //Make the next node the head of the linked list.
-                nodes[key] = *currentNode->next;
+                //removing the first node in the list, which lives in the table itself.
+                //Move the next node into the bucket and free that one, or empty the bucket.
+                Node* nextNode = currentNode->next;
+                if (nextNode == nullptr) {
+                    nodes[key] = Node();
+                }
+                else {
+                    nodes[key] = *nextNode;
+                    pool.Delete(nextNode);
+                }
             }
             else {
                 //removing a node in the middle or end of the list.
                 lastNode->next = currentNode->next;
+
+                //Free the memory used by the node.
+                pool.Delete(currentNode);
             }
-            //Free the memory used by the node.
-            delete currentNode;
             cout << "Bid Id " << bidId << " removed." << endl;
             return;
         }
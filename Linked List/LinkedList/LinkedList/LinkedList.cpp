@@ -7,10 +7,33 @@
 //============================================================================
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <thread>
 #include <time.h>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "CSVparser.hpp"
+#include "NodePool.hpp"
 
 using namespace std;
 
@@ -32,10 +55,54 @@ struct Bid {
     }
 };
 
+// the bid fields a list can be sorted on
+enum SortKey {
+    SORT_BY_TITLE,
+    SORT_BY_ID,
+    SORT_BY_AMOUNT,
+    SORT_BY_FUND
+};
+
+/**
+ * Compare two bids on the given sort key
+ *
+ * Bid ids are compared by length first so that numeric ids
+ * order numerically ("999" before "1000").
+ *
+ * @param a the left hand bid
+ * @param b the right hand bid
+ * @param key the field to compare on
+ * @return true if a orders strictly before b
+ */
+bool bidLess(const Bid& a, const Bid& b, SortKey key) {
+    switch (key) {
+    case SORT_BY_ID:
+        if (a.bidId.size() != b.bidId.size()) {
+            return a.bidId.size() < b.bidId.size();
+        }
+        return a.bidId < b.bidId;
+    case SORT_BY_AMOUNT:
+        return a.amount < b.amount;
+    case SORT_BY_FUND:
+        return a.fund < b.fund;
+    default:
+        return a.title < b.title;
+    }
+}
+
 //============================================================================
 // Linked-List class definition
 //============================================================================
 
+// how LinkedList::Search reorders the list after finding a bid, so bids
+// that are looked up often drift towards the head
+enum SearchPolicy {
+    SEARCH_STATIC,          // never reorder
+    SEARCH_MOVE_TO_FRONT,   // move the found bid to the head
+    SEARCH_TRANSPOSE,       // swap the found bid with the one before it
+    SEARCH_FREQUENCY_COUNT  // keep the list ordered by access count
+};
+
 /**
  * Define a class containing data members and methods to
  * implement a linked-list.
@@ -47,16 +114,35 @@ private:
     struct Node {
         Bid bid;
         Node *next;
+        Node *prev;
+        unsigned int accesses; // times Search has found this node
 
         // default constructor
         Node() {
             next = nullptr;
+            prev = nullptr;
+            accesses = 0;
         }
 
         // initialize with a bid
         Node(Bid aBid) {
             bid = aBid;
             next = nullptr;
+            prev = nullptr;
+            accesses = 0;
+        }
+    };
+
+    // index entry: the first node in list order with a bidId, and how
+    // many nodes share it
+    struct IndexEntry {
+        Node* first;
+        int count;
+
+        // default constructor
+        IndexEntry() {
+            first = nullptr;
+            count = 0;
         }
     };
 
@@ -64,8 +150,25 @@ private:
     Node* tail;
     int size = 0;
 
+    // nodes come from slabs instead of one heap allocation each
+    NodePool<Node> pool;
+
+    // optional bidId index making Search and Remove constant time
+    bool indexed = false;
+    unordered_map<string, IndexEntry> index;
+
+    // how Search reorders the list
+    SearchPolicy policy = SEARCH_STATIC;
+
+    Node* findNode(string bidId);
+    void detachNode(Node* node);
+    void insertBefore(Node* node, Node* position);
+    void unlinkNode(Node* node);
+    void reorganize(Node* node);
+
 public:
     LinkedList();
+    LinkedList(bool useIndex);
     virtual ~LinkedList();
     void Append(Bid bid);
     void Prepend(Bid bid);
@@ -73,6 +176,10 @@ public:
     void Remove(string bidId);
     Bid Search(string bidId);
     int Size();
+    void ForEach(function<void(const Bid&)> visit);
+    void Splice(LinkedList&& other);
+    void SetSearchPolicy(SearchPolicy searchPolicy);
+    void Sort(SortKey key);
 };
 
 /**
@@ -85,6 +192,16 @@ LinkedList::LinkedList() {
     tail = nullptr;
 }
 
+/**
+ * Constructor choosing whether to keep a bidId index alongside the list.
+ * The list keeps its insertion order either way.
+ *
+ * @param useIndex true to make Search and Remove constant time
+ */
+LinkedList::LinkedList(bool useIndex) : LinkedList() {
+    indexed = useIndex;
+}
+
 /**
  * Destructor
  */
@@ -97,8 +214,9 @@ LinkedList::~LinkedList() {
     while (current != nullptr) {
         tempNode = current; // hang on to current node
         current = current->next; // make current the next node
-        delete tempNode; // delete the orphan node
+        pool.Delete(tempNode); // delete the orphan node
     }
+    // the pool then frees its slabs in one pass
 }
 
 /**
@@ -106,7 +224,7 @@ LinkedList::~LinkedList() {
  */
 void LinkedList::Append(Bid bid) {
     //Creating a new node
-    Node* nextNode = new Node(bid);
+    Node* nextNode = pool.New(bid);
 
     if (head == nullptr) {
         //if the list is empty, both the head and tail would point to the next node.
@@ -116,12 +234,20 @@ void LinkedList::Append(Bid bid) {
     else {
         //if the list is not empty, append to the end of the list.
         tail->next = nextNode; // current tail node points to the new node
+        nextNode->prev = tail; // and back again
         tail = nextNode; // update the tail to the new node.
     }
     
     //increment the size of the linked list.
     size++;
- 
+
+    //a bidId already in the list keeps its earlier node as the first match.
+    if (indexed) {
+        IndexEntry& entry = index[bid.bidId];
+        if (entry.count++ == 0) {
+            entry.first = nextNode;
+        }
+    }
 }
 
 /**
@@ -129,13 +255,17 @@ void LinkedList::Append(Bid bid) {
  */
 void LinkedList::Prepend(Bid bid) {
     //creating a new node.
-    Node* nextNode = new Node(bid);
+    Node* nextNode = pool.New(bid);
 
     //Checks to see if the list is not empty.
     if (head != nullptr) {
         //if the list is not empty, make the new node's next pointer point to the current head of the list.
         nextNode->next = head;
-        
+        head->prev = nextNode;
+    }
+    else {
+        //the only node is also the tail.
+        tail = nextNode;
     }
     // set the new node as the head of the list.
     head = nextNode;
@@ -143,6 +273,12 @@ void LinkedList::Prepend(Bid bid) {
     //increment the size of the list by one since a new node was added to the front of the list.
     size++;
 
+    //the new node is now the first match for its bidId.
+    if (indexed) {
+        IndexEntry& entry = index[bid.bidId];
+        entry.first = nextNode;
+        entry.count++;
+    }
 }
 
 /**
@@ -166,47 +302,163 @@ void LinkedList::PrintList() {
   
 }
 
+/**
+ * Find the first node holding a bidId, through the index when there
+ * is one or by walking from the head
+ *
+ * @param bidId The bid id to search for
+ * @return the node, or nullptr when no bid matches
+ */
+LinkedList::Node* LinkedList::findNode(string bidId) {
+    if (indexed) {
+        unordered_map<string, IndexEntry>::iterator it = index.find(bidId);
+        return it == index.end() ? nullptr : it->second.first;
+    }
+
+    //Start at the head of the list.
+    Node* currentNode = head;
+
+    //loop through the list until the end is reached.
+    while (currentNode != nullptr) {
+        // if the current node's bidId matches the given bidId, return the node.
+        if (currentNode->bid.bidId == bidId) {
+            return currentNode;
+        }
+        //move to the next node.
+        currentNode = currentNode->next;
+    }
+    return nullptr;
+}
+
+/**
+ * Take a node out of the chain without freeing it
+ *
+ * @param node The node to detach
+ */
+void LinkedList::detachNode(Node* node) {
+    //point the neighbours past the node, moving head or tail when it's an end.
+    if (node->prev == nullptr) {
+        head = node->next;
+    }
+    else {
+        node->prev->next = node->next;
+    }
+    if (node->next == nullptr) {
+        tail = node->prev;
+    }
+    else {
+        node->next->prev = node->prev;
+    }
+    node->next = nullptr;
+    node->prev = nullptr;
+}
+
+/**
+ * Link a detached node back into the chain
+ *
+ * @param node The node to link in
+ * @param position The node it goes in front of, nullptr for the end
+ */
+void LinkedList::insertBefore(Node* node, Node* position) {
+    node->next = position;
+    node->prev = position == nullptr ? tail : position->prev;
+    if (node->prev == nullptr) {
+        head = node;
+    }
+    else {
+        node->prev->next = node;
+    }
+    if (position == nullptr) {
+        tail = node;
+    }
+    else {
+        position->prev = node;
+    }
+}
+
+/**
+ * Unlink a node from its neighbours and the index, then free it
+ *
+ * @param node The first node in the list holding its bidId
+ */
+void LinkedList::unlinkNode(Node* node) {
+    Node* following = node->next;
+    detachNode(node);
+
+    if (indexed) {
+        unordered_map<string, IndexEntry>::iterator it = index.find(node->bid.bidId);
+        if (--it->second.count == 0) {
+            index.erase(it);
+        }
+        else if (it->second.first == node) {
+            //another node shares the bidId and, this being the first, comes later.
+            Node* nextMatch = following;
+            while (nextMatch->bid.bidId != node->bid.bidId) {
+                nextMatch = nextMatch->next;
+            }
+            it->second.first = nextMatch;
+        }
+    }
+
+    pool.Delete(node); // frees up memory
+    size--; // decreases the size of the linked list.
+}
+
 /**
  * Remove a specified bid
  *
  * @param bidId The bid id to remove from the list
  */
 void LinkedList::Remove(string bidId) {
-    // declare Node* variables
-    Node* currentNode = nullptr;
-    Node* tempNode = nullptr;
-
-    if (head == nullptr) {
-        //if the list is empty then it returns nothing.
-        return;
+    //only the first bid with a matching bidId is removed.
+    Node* node = findNode(bidId);
+    if (node != nullptr) {
+        unlinkNode(node);
     }
-    //special case: if the head node has to be removed
-    if (head->bid.bidId == bidId) {
-        //Saves the current head node, moves the head pointer to the next node, and removes the old head node.
-        //The size of the list is decreased before the loop is broken.
-        tempNode = head;
-        head = head->next;
-        delete tempNode;
-        size--;
+}
 
+/**
+ * Count a successful search and move the node forward as the search
+ * policy says. The node is the first with its bidId, so moving it
+ * towards the head keeps it first and the index stays correct.
+ *
+ * @param node The node Search found
+ */
+void LinkedList::reorganize(Node* node) {
+    node->accesses++;
+    if (node == head) {
         return;
     }
 
-    //General case to remove a node from the linked list if bidId matches.
-    currentNode = head;
-    while (currentNode->next != nullptr) {
-        // if the next node has the matching bidId.
-        if (currentNode->next->bid.bidId == bidId) {
-            tempNode = currentNode->next; // holding the current node to remove
-            currentNode->next = tempNode->next; //move current node beyond the next node.
-            delete tempNode; // frees up memory 
-            size--; // decreases the size of the linked list.
+    switch (policy) {
+    case SEARCH_MOVE_TO_FRONT:
+        detachNode(node);
+        insertBefore(node, head);
+        break;
 
-            return; //exits the loop.
+    case SEARCH_TRANSPOSE: {
+        Node* previous = node->prev;
+        detachNode(node);
+        insertBefore(node, previous);
+        break;
+    }
 
+    case SEARCH_FREQUENCY_COUNT: {
+        //step back past every node searched for less often
+        Node* position = node->prev;
+        while (position != nullptr && position->accesses < node->accesses) {
+            position = position->prev;
         }
-        //move to the next node.
-        currentNode = currentNode->next;
+        Node* target = position == nullptr ? head : position->next;
+        if (target != node) {
+            detachNode(node);
+            insertBefore(node, target);
+        }
+        break;
+    }
+
+    default:
+        break;
     }
 }
 
@@ -216,23 +468,11 @@ void LinkedList::Remove(string bidId) {
  * @param bidId The bid id to search for
  */
 Bid LinkedList::Search(string bidId) {
-    //Special case: if the matching bid is the head.
-    if (head != nullptr && head->bid.bidId == bidId) {
-        //returns the bid from the head.
-        return head->bid;
-    }
-
-    //Start at the head of the list.
-    Node* currentNode = head;
-
-    //loop through the list until the end is reached.
-    while (currentNode != nullptr) {
-        // if the current node's bidId matches the given bidId, return the corresponding bid.
-        if (currentNode->bid.bidId == bidId) {
-            return currentNode->bid;
-        }
-        //move to the next node.
-        currentNode = currentNode->next;
+    Node* node = findNode(bidId);
+    if (node != nullptr) {
+        Bid bid = node->bid;
+        reorganize(node);
+        return bid;
     }
     //if no match was found, it would return an empty bid.
     return Bid();
@@ -245,151 +485,2274 @@ int LinkedList::Size() {
     return size;
 }
 
-//============================================================================
-// Static methods used for testing
-//============================================================================
-
 /**
- * Display the bid information
+ * Visit every bid from head to tail without reordering the list
  *
- * @param bid struct containing the bid info
+ * @param visit Called with each bid in turn
  */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount
-         << " | " << bid.fund << endl;
-    return;
+void LinkedList::ForEach(function<void(const Bid&)> visit) {
+    for (Node* node = head; node != nullptr; node = node->next) {
+        visit(node->bid);
+    }
 }
 
 /**
- * Prompt user for bid information
+ * Choose how Search reorders the list. Under a skewed lookup pattern
+ * the popular bids gather near the head, so an unindexed search walks
+ * only a few nodes for them. Reordering gives up insertion order.
  *
- * @return Bid struct containing the bid info
+ * @param searchPolicy The reordering to apply after each found bid
  */
-Bid getBid() {
-    Bid bid;
-
-    cout << "Enter Id: ";
-    cin.ignore();
-    getline(cin, bid.bidId);
-
-    cout << "Enter title: ";
-    getline(cin, bid.title);
-
-    cout << "Enter fund: ";
-    cin >> bid.fund;
-
-    cout << "Enter amount: ";
-    cin.ignore();
-    string strAmount;
-    getline(cin, strAmount);
-    bid.amount = strToDouble(strAmount, '$');
-
-    return bid;
+void LinkedList::SetSearchPolicy(SearchPolicy searchPolicy) {
+    policy = searchPolicy;
 }
 
 /**
- * Load a CSV file containing bids into a LinkedList
+ * Sort the list in place with a bottom-up merge sort that only relinks
+ * nodes: O(n log n) comparisons, no extra memory, and bids with equal
+ * keys keep their order. Each pass merges neighbouring sorted runs of
+ * width nodes into runs of twice the width.
  *
- * @return a LinkedList containing all the bids read
+ * @param key The bid field to order on
  */
-void loadBids(string csvPath, LinkedList *list) {
-    cout << "Loading CSV file " << csvPath << endl;
-
-    // initialize the CSV Parser
-    csv::Parser file = csv::Parser(csvPath);
+void LinkedList::Sort(SortKey key) {
+    if (head == nullptr) {
+        return;
+    }
 
-    try {
-        // loop to read rows of a CSV file
-        for (int i = 0; i < file.rowCount(); i++) {
+    for (int width = 1;; width *= 2) {
+        Node* left = head;
+        Node* last = nullptr;
+        int merges = 0;
+        head = nullptr;
+
+        while (left != nullptr) {
+            merges++;
+
+            //the right run starts width nodes after the left one
+            Node* right = left;
+            int leftSize = 0;
+            while (leftSize < width && right != nullptr) {
+                leftSize++;
+                right = right->next;
+            }
+            int rightSize = width;
+
+            //merge the runs, taking from the left on ties to stay stable
+            while (leftSize > 0 || (rightSize > 0 && right != nullptr)) {
+                Node* next;
+                if (leftSize == 0) {
+                    next = right;
+                    right = right->next;
+                    rightSize--;
+                }
+                else if (rightSize == 0 || right == nullptr || !bidLess(right->bid, left->bid, key)) {
+                    next = left;
+                    left = left->next;
+                    leftSize--;
+                }
+                else {
+                    next = right;
+                    right = right->next;
+                    rightSize--;
+                }
+
+                //append to the merged list, fixing prev as we go
+                if (last == nullptr) {
+                    head = next;
+                }
+                else {
+                    last->next = next;
+                }
+                next->prev = last;
+                last = next;
+            }
 
-            // initialize a bid using data from current row (i)
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
+            left = right;
+        }
 
-            //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
+        last->next = nullptr;
+        tail = last;
 
-            // add this bid to the end
-            list->Append(bid);
+        //a single merge means the whole list was one run
+        if (merges <= 1) {
+            break;
         }
-    } catch (csv::Error &e) {
-        std::cerr << e.what() << std::endl;
     }
-}
 
-/**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
- *
- * credit: http://stackoverflow.com/a/24875936
- *
- * @param ch The character to strip out
- */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+    //the first node for a bidId may have changed
+    if (indexed) {
+        index.clear();
+        for (Node* node = head; node != nullptr; node = node->next) {
+            IndexEntry& entry = index[node->bid.bidId];
+            if (entry.count++ == 0) {
+                entry.first = node;
+            }
+        }
+    }
 }
 
 /**
- * The one and only main() method
+ * Move every node of another list onto the end of this one without
+ * copying them. The other list's pool hands its slabs to this list's
+ * pool, so the nodes stay where they are. Linking the chains is O(1);
+ * an indexed list also adds each moved node to its index.
  *
- * @param arg[1] path to CSV file to load from (optional)
- * @param arg[2] the bid Id to use when searching the list (optional)
+ * @param other The list to empty onto this one
  */
-int main(int argc, char* argv[]) {
+void LinkedList::Splice(LinkedList&& other) {
+    if (&other == this || other.head == nullptr) {
+        return;
+    }
 
-    // process command line arguments
-    string csvPath, bidKey;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        bidKey = "98109";
-        break;
-    case 3:
-        csvPath = argv[1];
-        bidKey = argv[2];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
-        bidKey = "98109";
+    //index the incoming nodes before they join, first matches stay first
+    if (indexed) {
+        for (Node* node = other.head; node != nullptr; node = node->next) {
+            IndexEntry& entry = index[node->bid.bidId];
+            if (entry.count++ == 0) {
+                entry.first = node;
+            }
+        }
     }
 
-    clock_t ticks;
+    //link the two chains
+    if (head == nullptr) {
+        head = other.head;
+    }
+    else {
+        tail->next = other.head;
+        other.head->prev = tail;
+    }
+    tail = other.tail;
+    size += other.size;
+    pool.Adopt(other.pool);
+
+    //leave the other list empty
+    other.head = nullptr;
+    other.tail = nullptr;
+    other.size = 0;
+    other.index.clear();
+}
 
-    LinkedList bidList;
+//============================================================================
+// Unrolled linked-list class definition
+//============================================================================
 
-    Bid bid;
+// bids held by each block of the unrolled list
+const int UNROLLED_BLOCK_CAPACITY = 16;
 
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Enter a Bid" << endl;
-        cout << "  2. Load Bids" << endl;
-        cout << "  3. Display All Bids" << endl;
-        cout << "  4. Find Bid" << endl;
-        cout << "  5. Remove Bid" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
+/**
+ * Define a class with the same methods as LinkedList but storing the
+ * bids in blocks of up to UNROLLED_BLOCK_CAPACITY, so walking the list
+ * reads mostly sequential memory instead of one heap node per bid.
+ */
+class UnrolledLinkedList {
 
-        switch (choice) {
-        case 1:
-            bid = getBid();
-            bidList.Append(bid);
-            displayBid(bid);
+private:
+    //Internal structure for a block of list entries, housekeeping variables
+    struct Block {
+        Bid bids[UNROLLED_BLOCK_CAPACITY];
+        int count;
+        Block* next;
 
-            break;
+        // default constructor
+        Block() {
+            count = 0;
+            next = nullptr;
+        }
+    };
 
-        case 2:
-            ticks = clock();
+    Block* head;
+    Block* tail;
+    int size = 0;
 
-            loadBids(csvPath, &bidList);
+    NodePool<Block> pool;
 
-            cout << bidList.Size() << " bids read" << endl;
+    void removeAt(Block* previous, Block* block, int index);
 
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+public:
+    UnrolledLinkedList();
+    virtual ~UnrolledLinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+UnrolledLinkedList::UnrolledLinkedList() {
+    head = nullptr;
+    tail = nullptr;
+}
+
+/**
+ * Destructor
+ */
+UnrolledLinkedList::~UnrolledLinkedList() {
+    // loop over each block, detach from list then delete
+    while (head != nullptr) {
+        Block* tempBlock = head;
+        head = head->next;
+        pool.Delete(tempBlock);
+    }
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void UnrolledLinkedList::Append(Bid bid) {
+    //start a new block when the last one is full
+    if (tail == nullptr || tail->count == UNROLLED_BLOCK_CAPACITY) {
+        Block* nextBlock = pool.New();
+        if (head == nullptr) {
+            head = nextBlock;
+        }
+        else {
+            tail->next = nextBlock;
+        }
+        tail = nextBlock;
+    }
+
+    tail->bids[tail->count++] = bid;
+    size++;
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void UnrolledLinkedList::Prepend(Bid bid) {
+    //start a new block in front when the first one is full
+    if (head == nullptr || head->count == UNROLLED_BLOCK_CAPACITY) {
+        Block* nextBlock = pool.New();
+        nextBlock->next = head;
+        head = nextBlock;
+        if (tail == nullptr) {
+            tail = nextBlock;
+        }
+    }
+
+    //shift the block's bids up one slot to make room at the front
+    for (int i = head->count; i > 0; --i) {
+        head->bids[i] = std::move(head->bids[i - 1]);
+    }
+    head->bids[0] = bid;
+    head->count++;
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void UnrolledLinkedList::PrintList() {
+    for (Block* block = head; block != nullptr; block = block->next) {
+        for (int i = 0; i < block->count; ++i) {
+            cout << block->bids[i].bidId << ": "
+                << block->bids[i].title << " | "
+                << block->bids[i].amount << " | "
+                << block->bids[i].fund << endl;
+        }
+    }
+}
+
+/**
+ * Remove one bid from a block, keeping blocks at least half full by
+ * merging a block with its successor when both fit in one
+ *
+ * @param previous The block before block, or nullptr when it's the head
+ * @param block The block holding the bid
+ * @param index The bid's slot in the block
+ */
+void UnrolledLinkedList::removeAt(Block* previous, Block* block, int index) {
+    //close the gap left by the removed bid
+    for (int i = index; i < block->count - 1; ++i) {
+        block->bids[i] = std::move(block->bids[i + 1]);
+    }
+    block->bids[--block->count] = Bid();
+    size--;
+
+    if (block->count == 0) {
+        //unlink and free an empty block
+        if (previous == nullptr) {
+            head = block->next;
+        }
+        else {
+            previous->next = block->next;
+        }
+        if (tail == block) {
+            tail = previous;
+        }
+        pool.Delete(block);
+    }
+    else if (block->next != nullptr && block->count < UNROLLED_BLOCK_CAPACITY / 2
+        && block->count + block->next->count <= UNROLLED_BLOCK_CAPACITY) {
+        //pull the next block's bids into this one and free it
+        Block* nextBlock = block->next;
+        for (int i = 0; i < nextBlock->count; ++i) {
+            block->bids[block->count++] = std::move(nextBlock->bids[i]);
+        }
+        block->next = nextBlock->next;
+        if (tail == nextBlock) {
+            tail = block;
+        }
+        pool.Delete(nextBlock);
+    }
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void UnrolledLinkedList::Remove(string bidId) {
+    Block* previous = nullptr;
+    for (Block* block = head; block != nullptr; block = block->next) {
+        for (int i = 0; i < block->count; ++i) {
+            if (block->bids[i].bidId == bidId) {
+                removeAt(previous, block, i);
+                return;
+            }
+        }
+        previous = block;
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid UnrolledLinkedList::Search(string bidId) {
+    for (Block* block = head; block != nullptr; block = block->next) {
+        for (int i = 0; i < block->count; ++i) {
+            if (block->bids[i].bidId == bidId) {
+                return block->bids[i];
+            }
+        }
+    }
+    //if no match was found, it would return an empty bid.
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int UnrolledLinkedList::Size() {
+    return size;
+}
+
+//============================================================================
+// Lock-free concurrent linked-list class definition
+//============================================================================
+
+// threads that can be inside list operations at the same time
+const int MAX_EPOCH_SLOTS = 128;
+
+// retired nodes gathered before trying to free any
+const size_t RECLAIM_THRESHOLD = 64;
+
+/**
+ * Define a class with LinkedList's methods that any number of threads
+ * can call at once. Append and Prepend link nodes in with a
+ * compare-and-swap on the tail or head, Search and PrintList only read,
+ * and Remove first marks a node deleted (the low bit of its next
+ * pointer) then unlinks it, as in Harris' list. Unlinked nodes are
+ * freed by epoch-based reclamation once no thread can still be reading
+ * them.
+ *
+ * A marked node is only unlinked once it has a successor, so the last
+ * node stays in place (still deleted) until something is appended after
+ * it. Every node carries its position along the list (seq), and a node
+ * is only retired once tail has moved past it, so tail never points at
+ * freed memory.
+ */
+class ConcurrentLinkedList {
+
+private:
+    //Internal structure for list entries
+    struct Node {
+        Bid bid;
+        atomic<uintptr_t> next;
+        long long seq;
+
+        // default constructor
+        Node() : next(0) {
+            seq = 0;
+        }
+
+        // initialize with a bid
+        Node(Bid aBid) : Node() {
+            bid = aBid;
+        }
+    };
+
+    // one thread's announcement of the epoch it is reading in
+    struct EpochSlot {
+        atomic<bool> inUse;
+        atomic<unsigned long long> epoch; // 0 while the slot is idle
+
+        // default constructor
+        EpochSlot() : inUse(false), epoch(0) {
+        }
+    };
+
+    // a node waiting until no reader can still hold it
+    struct RetiredNode {
+        Node* node;
+        unsigned long long epoch;
+    };
+
+    /**
+     * Holds an epoch slot for the length of one list operation
+     */
+    class EpochGuard {
+    private:
+        EpochSlot* slot;
+    public:
+        EpochGuard(ConcurrentLinkedList* list);
+        ~EpochGuard();
+    };
+
+    Node head; // sentinel, never removed and never marked
+    atomic<Node*> tail;
+    atomic<int> size;
+
+    atomic<unsigned long long> globalEpoch;
+    EpochSlot slots[MAX_EPOCH_SLOTS];
+    mutex retiredMutex;
+    vector<RetiredNode> retired;
+
+    static Node* pointer(uintptr_t link);
+    static bool marked(uintptr_t link);
+    Node* findLive(const string& bidId);
+    void unlinkMarked();
+    void retire(Node* node);
+
+public:
+    ConcurrentLinkedList();
+    virtual ~ConcurrentLinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Claim a free slot and announce the current epoch in it
+ */
+ConcurrentLinkedList::EpochGuard::EpochGuard(ConcurrentLinkedList* list) {
+    // start probing at a per-thread spot so threads rarely collide
+    static thread_local unsigned int hint = (unsigned int)hash<thread::id>()(this_thread::get_id());
+    slot = nullptr;
+    for (unsigned int i = hint;; ++i) {
+        EpochSlot& candidate = list->slots[i % MAX_EPOCH_SLOTS];
+        bool expected = false;
+        if (!candidate.inUse.load() && candidate.inUse.compare_exchange_strong(expected, true)) {
+            slot = &candidate;
+            hint = i;
+            break;
+        }
+        if (i - hint >= MAX_EPOCH_SLOTS) {
+            this_thread::yield();
+        }
+    }
+    //announce an epoch that is still current, so it can't be two behind already
+    unsigned long long epoch;
+    do {
+        epoch = list->globalEpoch.load();
+        slot->epoch.store(epoch);
+    } while (list->globalEpoch.load() != epoch);
+}
+
+/**
+ * Leave the epoch and free the slot
+ */
+ConcurrentLinkedList::EpochGuard::~EpochGuard() {
+    slot->epoch.store(0);
+    slot->inUse.store(false);
+}
+
+/**
+ * Default constructor
+ */
+ConcurrentLinkedList::ConcurrentLinkedList() : tail(&head), size(0), globalEpoch(1) {
+    head.seq = LLONG_MIN;
+}
+
+/**
+ * Destructor, no other thread may be using the list
+ */
+ConcurrentLinkedList::~ConcurrentLinkedList() {
+    Node* current = pointer(head.next.load());
+    while (current != nullptr) {
+        Node* tempNode = current;
+        current = pointer(current->next.load());
+        delete tempNode;
+    }
+    for (size_t i = 0; i < retired.size(); ++i) {
+        delete retired[i].node;
+    }
+}
+
+/**
+ * The node a link points at, without the deleted mark
+ */
+ConcurrentLinkedList::Node* ConcurrentLinkedList::pointer(uintptr_t link) {
+    return reinterpret_cast<Node*>(link & ~(uintptr_t)1);
+}
+
+/**
+ * Whether the node owning a link has been deleted
+ */
+bool ConcurrentLinkedList::marked(uintptr_t link) {
+    return (link & 1) != 0;
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void ConcurrentLinkedList::Append(Bid bid) {
+    EpochGuard guard(this);
+    Node* nextNode = new Node(bid);
+
+    while (true) {
+        Node* last = tail.load();
+        uintptr_t link = last->next.load();
+
+        //tail lags behind the real end, help move it on and retry.
+        if (pointer(link) != nullptr) {
+            tail.compare_exchange_strong(last, pointer(link));
+            continue;
+        }
+
+        //link in after the last node, keeping its deleted mark if it has one.
+        nextNode->seq = last == &head ? 0 : last->seq + 1;
+        if (last->next.compare_exchange_strong(link, reinterpret_cast<uintptr_t>(nextNode) | (link & 1))) {
+            tail.compare_exchange_strong(last, nextNode);
+            break;
+        }
+    }
+    size++;
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void ConcurrentLinkedList::Prepend(Bid bid) {
+    EpochGuard guard(this);
+    Node* nextNode = new Node(bid);
+
+    while (true) {
+        uintptr_t first = head.next.load();
+        Node* firstNode = pointer(first);
+        nextNode->next.store(first);
+        nextNode->seq = firstNode == nullptr ? 0 : firstNode->seq - 1;
+        if (head.next.compare_exchange_strong(first, reinterpret_cast<uintptr_t>(nextNode))) {
+            break;
+        }
+    }
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void ConcurrentLinkedList::PrintList() {
+    EpochGuard guard(this);
+    for (Node* current = pointer(head.next.load()); current != nullptr; ) {
+        uintptr_t link = current->next.load();
+        if (!marked(link)) {
+            cout << current->bid.bidId << ": "
+                << current->bid.title << " | "
+                << current->bid.amount << " | "
+                << current->bid.fund << endl;
+        }
+        current = pointer(link);
+    }
+}
+
+/**
+ * Find the first node holding a bidId that isn't deleted,
+ * called inside an EpochGuard
+ */
+ConcurrentLinkedList::Node* ConcurrentLinkedList::findLive(const string& bidId) {
+    for (Node* current = pointer(head.next.load()); current != nullptr; ) {
+        uintptr_t link = current->next.load();
+        if (!marked(link) && current->bid.bidId == bidId) {
+            return current;
+        }
+        current = pointer(link);
+    }
+    return nullptr;
+}
+
+/**
+ * Walk the list unlinking every deleted node that has a successor,
+ * called inside an EpochGuard
+ */
+void ConcurrentLinkedList::unlinkMarked() {
+    Node* previous = &head;
+    Node* current = pointer(head.next.load());
+
+    while (current != nullptr) {
+        uintptr_t link = current->next.load();
+        if (marked(link) && pointer(link) != nullptr) {
+            //swing the previous node past this one, only the winner retires it.
+            uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+            if (previous->next.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pointer(link)))) {
+                retire(current);
+                current = pointer(link);
+            }
+            else {
+                //the previous node changed under us, start again from the head.
+                previous = &head;
+                current = pointer(head.next.load());
+            }
+            continue;
+        }
+        previous = current;
+        current = pointer(link);
+    }
+}
+
+/**
+ * Hand an unlinked node to the reclaimer, freeing older ones when every
+ * thread has moved on two epochs since they were retired
+ */
+void ConcurrentLinkedList::retire(Node* node) {
+    //tail must be past the node first; the node has a successor, so it can be.
+    while (true) {
+        Node* last = tail.load();
+        if (last->seq > node->seq) {
+            break;
+        }
+        Node* nextNode = pointer(last->next.load());
+        tail.compare_exchange_strong(last, nextNode);
+    }
+
+    vector<Node*> freeable;
+    {
+        lock_guard<mutex> lock(retiredMutex);
+        RetiredNode entry;
+        entry.node = node;
+        entry.epoch = globalEpoch.load();
+        retired.push_back(entry);
+        if (retired.size() < RECLAIM_THRESHOLD) {
+            return;
+        }
+
+        //move the epoch on if every active thread has seen the current one.
+        unsigned long long epoch = globalEpoch.load();
+        bool current = true;
+        for (int i = 0; i < MAX_EPOCH_SLOTS; ++i) {
+            unsigned long long seen = slots[i].epoch.load();
+            if (seen != 0 && seen != epoch) {
+                current = false;
+                break;
+            }
+        }
+        if (current) {
+            globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+        }
+
+        //nodes retired two epochs ago can't be held by anyone any more.
+        unsigned long long safeEpoch = globalEpoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); ++i) {
+            if (retired[i].epoch + 2 <= safeEpoch) {
+                freeable.push_back(retired[i].node);
+            }
+            else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+    for (size_t i = 0; i < freeable.size(); ++i) {
+        delete freeable[i];
+    }
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void ConcurrentLinkedList::Remove(string bidId) {
+    EpochGuard guard(this);
+
+    while (true) {
+        Node* node = findLive(bidId);
+        if (node == nullptr) {
+            return;
+        }
+        //mark it deleted; losing the race means another thread removed it first.
+        uintptr_t link = node->next.load();
+        if (!marked(link) && node->next.compare_exchange_strong(link, link | 1)) {
+            size--;
+            break;
+        }
+    }
+    unlinkMarked();
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid ConcurrentLinkedList::Search(string bidId) {
+    EpochGuard guard(this);
+    Node* node = findLive(bidId);
+    if (node != nullptr) {
+        return node->bid;
+    }
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int ConcurrentLinkedList::Size() {
+    return size.load();
+}
+
+//============================================================================
+// Skip list class definition
+//============================================================================
+
+// tallest tower a skip list node can have; with a 1 in 4 chance of
+// growing each level this covers billions of bids
+const int SKIP_LIST_MAX_LEVEL = 16;
+
+/**
+ * Define a class with LinkedList's methods that keeps the bids ordered
+ * by bidId in a skip list, so Search and Remove take expected O(log n)
+ * steps and PrintList lists the bids in bidId order. Append and Prepend
+ * both insert at the bid's place in that order; a bid whose id is
+ * already present goes after the earlier ones.
+ *
+ * In concurrent-reader mode Search, PrintList and Size can run on many
+ * threads at once, while Append, Prepend and Remove take the list for
+ * themselves.
+ */
+class SkipList {
+
+private:
+    //Internal structure for list entries; the tower of next pointers
+    //is allocated in the same block, right after the node
+    struct Node {
+        Bid bid;
+        int level;
+        Node** next;
+    };
+
+    Node* head;
+    int level;
+    int size = 0;
+    unsigned int seed;
+
+    bool concurrentReaders;
+    shared_timed_mutex lock;
+
+    static Node* newNode(Bid bid, int level);
+    static void deleteNode(Node* node);
+    int randomLevel();
+    Node* findPrevious(const string& bidId, bool after, Node** update);
+    void insert(Bid bid);
+
+public:
+    SkipList();
+    SkipList(bool useConcurrentReaders);
+    virtual ~SkipList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+SkipList::SkipList() {
+    head = newNode(Bid(), SKIP_LIST_MAX_LEVEL);
+    level = 1;
+    seed = 2463534242u;
+    concurrentReaders = false;
+}
+
+/**
+ * Constructor choosing concurrent-reader mode
+ *
+ * @param useConcurrentReaders true to guard the list with a
+ *        readers-writer lock
+ */
+SkipList::SkipList(bool useConcurrentReaders) : SkipList() {
+    concurrentReaders = useConcurrentReaders;
+}
+
+/**
+ * Destructor
+ */
+SkipList::~SkipList() {
+    // the bottom level links every node
+    Node* current = head;
+    while (current != nullptr) {
+        Node* tempNode = current;
+        current = current->next[0];
+        deleteNode(tempNode);
+    }
+}
+
+/**
+ * Allocate a node with room for its tower of next pointers
+ */
+SkipList::Node* SkipList::newNode(Bid bid, int level) {
+    void* memory = ::operator new(sizeof(Node) + level * sizeof(Node*));
+    Node* node = new (memory) Node();
+    node->bid = bid;
+    node->level = level;
+    node->next = reinterpret_cast<Node**>(node + 1);
+    for (int i = 0; i < level; ++i) {
+        node->next[i] = nullptr;
+    }
+    return node;
+}
+
+/**
+ * Free a node made by newNode
+ */
+void SkipList::deleteNode(Node* node) {
+    node->~Node();
+    ::operator delete(node);
+}
+
+/**
+ * Pick a new node's height: each extra level has a 1 in 4 chance
+ */
+int SkipList::randomLevel() {
+    // xorshift, only called by writers so no synchronization needed
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    int height = 1;
+    unsigned int bits = seed;
+    while (height < SKIP_LIST_MAX_LEVEL && (bits & 3) == 0) {
+        ++height;
+        bits >>= 2;
+    }
+    return height;
+}
+
+/**
+ * Walk down from the top level to the last node before bidId
+ * (or, with after set, the last node not after it)
+ *
+ * @param update When not null, receives the last node visited on each level
+ * @return the bottom level node the walk stopped at
+ */
+SkipList::Node* SkipList::findPrevious(const string& bidId, bool after, Node** update) {
+    Node* current = head;
+    for (int i = level - 1; i >= 0; --i) {
+        while (current->next[i] != nullptr
+            && (after ? !(bidId < current->next[i]->bid.bidId) : current->next[i]->bid.bidId < bidId)) {
+            current = current->next[i];
+        }
+        if (update != nullptr) {
+            update[i] = current;
+        }
+    }
+    return current;
+}
+
+/**
+ * Link a bid in at its place in bidId order, after any equal ids
+ */
+void SkipList::insert(Bid bid) {
+    Node* update[SKIP_LIST_MAX_LEVEL];
+    findPrevious(bid.bidId, true, update);
+
+    int height = randomLevel();
+    if (height > level) {
+        for (int i = level; i < height; ++i) {
+            update[i] = head;
+        }
+        level = height;
+    }
+
+    Node* node = newNode(bid, height);
+    for (int i = 0; i < height; ++i) {
+        node->next[i] = update[i]->next[i];
+        update[i]->next[i] = node;
+    }
+    size++;
+}
+
+/**
+ * Add a bid; the list is ordered so it goes at its bidId's place
+ */
+void SkipList::Append(Bid bid) {
+    if (concurrentReaders) {
+        unique_lock<shared_timed_mutex> writer(lock);
+        insert(bid);
+    }
+    else {
+        insert(bid);
+    }
+}
+
+/**
+ * Add a bid; the same as Append for an ordered list
+ */
+void SkipList::Prepend(Bid bid) {
+    Append(bid);
+}
+
+/**
+ * Simple output of all bids in the list, in bidId order
+ */
+void SkipList::PrintList() {
+    shared_lock<shared_timed_mutex> reader(lock, defer_lock);
+    if (concurrentReaders) {
+        reader.lock();
+    }
+
+    for (Node* current = head->next[0]; current != nullptr; current = current->next[0]) {
+        cout << current->bid.bidId << ": "
+            << current->bid.title << " | "
+            << current->bid.amount << " | "
+            << current->bid.fund << endl;
+    }
+}
+
+/**
+ * Remove a specified bid, the first one when several share the id
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void SkipList::Remove(string bidId) {
+    unique_lock<shared_timed_mutex> writer(lock, defer_lock);
+    if (concurrentReaders) {
+        writer.lock();
+    }
+
+    Node* update[SKIP_LIST_MAX_LEVEL];
+    Node* node = findPrevious(bidId, false, update)->next[0];
+    if (node == nullptr || node->bid.bidId != bidId) {
+        return;
+    }
+
+    //unlink it on every level it reaches
+    for (int i = 0; i < node->level; ++i) {
+        update[i]->next[i] = node->next[i];
+    }
+    while (level > 1 && head->next[level - 1] == nullptr) {
+        --level;
+    }
+    deleteNode(node);
+    size--;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid SkipList::Search(string bidId) {
+    shared_lock<shared_timed_mutex> reader(lock, defer_lock);
+    if (concurrentReaders) {
+        reader.lock();
+    }
+
+    Node* node = findPrevious(bidId, false, nullptr)->next[0];
+    if (node != nullptr && node->bid.bidId == bidId) {
+        return node->bid;
+    }
+    return Bid();
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int SkipList::Size() {
+    shared_lock<shared_timed_mutex> reader(lock, defer_lock);
+    if (concurrentReaders) {
+        reader.lock();
+    }
+    return size;
+}
+
+//============================================================================
+// LRU bid cache class definition
+//============================================================================
+
+// bids the menu's cache holds before evicting the least recently used
+const size_t BID_CACHE_CAPACITY = 1024;
+
+/**
+ * Define a class caching individual bids from a CSV file, so a lookup
+ * doesn't need the whole file loaded into a container. A hash index
+ * finds cached bids in O(1), and a doubly linked list keeps them in
+ * order of use: Get and Put move a bid to the head, and when the cache
+ * is full the bid at the tail (least recently used) is evicted.
+ *
+ * A miss reads the one row from the CSV file. The first miss scans the
+ * file once, recording where each bidId's row starts; later misses seek
+ * straight to the row and parse only that line.
+ */
+class BidCache {
+
+private:
+    //Internal structure for cache entries
+    struct Node {
+        Bid bid;
+        Node *next;
+        Node *prev;
+
+        // initialize with a bid
+        Node(Bid aBid) {
+            bid = aBid;
+            next = nullptr;
+            prev = nullptr;
+        }
+    };
+
+    Node* head; // most recently used
+    Node* tail; // least recently used
+    unordered_map<string, Node*> index;
+    NodePool<Node> pool;
+    size_t capacity;
+
+    // where to read misses from
+    string csvPath;
+    string header;
+    bool offsetsLoaded = false;
+    unordered_map<string, streamoff> offsets;
+
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+
+    void detachNode(Node* node);
+    void pushFront(Node* node);
+    void loadOffsets();
+    bool readBid(const string& bidId, Bid& bid);
+
+public:
+    BidCache(string path, size_t maxBids);
+    virtual ~BidCache();
+    Bid Get(string bidId);
+    void Put(Bid bid);
+    size_t Size();
+    long long Hits();
+    long long Misses();
+    long long Evictions();
+};
+
+/**
+ * Constructor
+ *
+ * @param path The CSV file misses are read from
+ * @param maxBids The most bids the cache holds at once
+ */
+BidCache::BidCache(string path, size_t maxBids) {
+    head = nullptr;
+    tail = nullptr;
+    capacity = max((size_t)1, maxBids);
+    csvPath = path;
+}
+
+/**
+ * Destructor
+ */
+BidCache::~BidCache() {
+    while (head != nullptr) {
+        Node* tempNode = head;
+        head = head->next;
+        pool.Delete(tempNode);
+    }
+}
+
+/**
+ * Take a node out of the recency list without freeing it
+ */
+void BidCache::detachNode(Node* node) {
+    if (node->prev == nullptr) {
+        head = node->next;
+    }
+    else {
+        node->prev->next = node->next;
+    }
+    if (node->next == nullptr) {
+        tail = node->prev;
+    }
+    else {
+        node->next->prev = node->prev;
+    }
+    node->next = nullptr;
+    node->prev = nullptr;
+}
+
+/**
+ * Link a node in as the most recently used
+ */
+void BidCache::pushFront(Node* node) {
+    node->next = head;
+    if (head != nullptr) {
+        head->prev = node;
+    }
+    head = node;
+    if (tail == nullptr) {
+        tail = node;
+    }
+}
+
+/**
+ * Scan the CSV file once, keeping the header line and where each
+ * bidId's first row starts
+ */
+void BidCache::loadOffsets() {
+    offsetsLoaded = true;
+
+    ifstream file(csvPath.c_str());
+    if (!file.is_open()) {
+        cerr << "Failed to open " << csvPath << endl;
+        return;
+    }
+    getline(file, header);
+
+    string line;
+    streamoff offset = file.tellg();
+    while (getline(file, line)) {
+        //the bidId is the second field; commas inside quotes don't count
+        bool quoted = false;
+        size_t start = string::npos;
+        for (size_t i = 0; i < line.length(); ++i) {
+            if (line[i] == '"') {
+                quoted = !quoted;
+            }
+            else if (line[i] == ',' && !quoted) {
+                if (start != string::npos) {
+                    offsets.insert(make_pair(line.substr(start, i - start), offset));
+                    break;
+                }
+                start = i + 1;
+            }
+        }
+        offset = file.tellg();
+    }
+}
+
+/**
+ * Read one bid from the CSV file
+ *
+ * @param bidId The bid id to read
+ * @param bid Receives the bid when it's found
+ * @return true when the file has a row for bidId
+ */
+bool BidCache::readBid(const string& bidId, Bid& bid) {
+    if (!offsetsLoaded) {
+        loadOffsets();
+    }
+    unordered_map<string, streamoff>::iterator it = offsets.find(bidId);
+    if (it == offsets.end()) {
+        return false;
+    }
+
+    ifstream file(csvPath.c_str());
+    string line;
+    file.seekg(it->second);
+    if (!getline(file, line)) {
+        return false;
+    }
+
+    try {
+        //parse the row the same way loadBids does, behind the file's header
+        csv::Parser row = csv::Parser(header + "\n" + line, csv::ePURE);
+        bid.bidId = row[0][1];
+        bid.title = row[0][0];
+        bid.fund = row[0][8];
+        bid.amount = strToDouble(row[0][4], '$');
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Look up a bid, reading it from the CSV file when it isn't cached
+ *
+ * @param bidId The bid id to look up
+ * @return the bid, or an empty bid when the file doesn't have it
+ */
+Bid BidCache::Get(string bidId) {
+    unordered_map<string, Node*>::iterator it = index.find(bidId);
+    if (it != index.end()) {
+        hits++;
+        detachNode(it->second);
+        pushFront(it->second);
+        return it->second->bid;
+    }
+
+    misses++;
+    Bid bid;
+    if (readBid(bidId, bid)) {
+        Put(bid);
+    }
+    return bid;
+}
+
+/**
+ * Cache a bid as the most recently used, evicting the least recently
+ * used bid when the cache is full
+ *
+ * @param bid The bid to cache
+ */
+void BidCache::Put(Bid bid) {
+    unordered_map<string, Node*>::iterator it = index.find(bid.bidId);
+    if (it != index.end()) {
+        it->second->bid = bid;
+        detachNode(it->second);
+        pushFront(it->second);
+        return;
+    }
+
+    if (index.size() >= capacity) {
+        Node* oldest = tail;
+        detachNode(oldest);
+        index.erase(oldest->bid.bidId);
+        pool.Delete(oldest);
+        evictions++;
+    }
+
+    Node* node = pool.New(bid);
+    pushFront(node);
+    index[bid.bidId] = node;
+}
+
+/**
+ * Returns the number of bids cached
+ */
+size_t BidCache::Size() {
+    return index.size();
+}
+
+/**
+ * Returns how many lookups were answered from the cache
+ */
+long long BidCache::Hits() {
+    return hits;
+}
+
+/**
+ * Returns how many lookups went to the CSV file
+ */
+long long BidCache::Misses() {
+    return misses;
+}
+
+/**
+ * Returns how many bids were pushed out to make room
+ */
+long long BidCache::Evictions() {
+    return evictions;
+}
+
+//============================================================================
+// Write-ahead log for LinkedList mutations
+//============================================================================
+
+// the flusher writes and syncs pending records at least this often...
+const unsigned int GROUP_COMMIT_MICROS = 2000;
+
+// ...or as soon as this many bytes are waiting
+const size_t GROUP_COMMIT_BYTES = 1 << 20;
+
+// a log longer than this is folded into a snapshot and started over
+const long long COMPACT_LOG_BYTES = 64LL << 20;
+
+// first bytes of a snapshot file
+const uint32_t SNAPSHOT_MAGIC = 0x42534E50;
+
+// the mutations a log record can hold
+enum LogRecordType {
+    LOG_APPEND = 1,
+    LOG_PREPEND = 2,
+    LOG_REMOVE = 3
+};
+
+/**
+ * Force a file's written data onto the disk
+ */
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * FNV-1a hash, used to spot records torn by a crash mid-write
+ */
+uint32_t logChecksum(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Add a length-prefixed string to a record
+ */
+void encodeField(string& buffer, const string& field) {
+    uint32_t length = (uint32_t)field.size();
+    buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    buffer.append(field);
+}
+
+/**
+ * Read a length-prefixed string from a record
+ *
+ * @return false when the record is too short
+ */
+bool decodeField(const string& buffer, size_t& pos, string& field) {
+    uint32_t length;
+    if (buffer.size() - pos < sizeof(length)) {
+        return false;
+    }
+    memcpy(&length, buffer.data() + pos, sizeof(length));
+    pos += sizeof(length);
+    if (buffer.size() - pos < length) {
+        return false;
+    }
+    field.assign(buffer, pos, length);
+    pos += length;
+    return true;
+}
+
+/**
+ * Add one record to a buffer. A record is its body length, then the
+ * body (log sequence number, type and bid), then the body's checksum.
+ */
+void encodeLogRecord(string& buffer, uint64_t lsn, LogRecordType type, const Bid& bid) {
+    string body;
+    body.append(reinterpret_cast<const char*>(&lsn), sizeof(lsn));
+    body.push_back((char)type);
+    encodeField(body, bid.bidId);
+    encodeField(body, bid.title);
+    encodeField(body, bid.fund);
+    body.append(reinterpret_cast<const char*>(&bid.amount), sizeof(bid.amount));
+
+    uint32_t length = (uint32_t)body.size();
+    uint32_t checksum = logChecksum(body.data(), body.size());
+    buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    buffer.append(body);
+    buffer.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+}
+
+/**
+ * Read the next record from a log or snapshot file
+ *
+ * @return false at the end of the file or at a torn or corrupt record
+ */
+bool readLogRecord(FILE* file, uint64_t& lsn, LogRecordType& type, Bid& bid) {
+    uint32_t length;
+    uint32_t checksum;
+    if (fread(&length, sizeof(length), 1, file) != 1 || length > (64u << 20)) {
+        return false;
+    }
+    string body(length, '\0');
+    if (fread(&body[0], 1, length, file) != length || fread(&checksum, sizeof(checksum), 1, file) != 1
+        || checksum != logChecksum(body.data(), body.size())) {
+        return false;
+    }
+
+    size_t pos = sizeof(lsn) + 1;
+    if (length < pos) {
+        return false;
+    }
+    memcpy(&lsn, body.data(), sizeof(lsn));
+    type = (LogRecordType)body[sizeof(lsn)];
+    if (!decodeField(body, pos, bid.bidId) || !decodeField(body, pos, bid.title)
+        || !decodeField(body, pos, bid.fund) || body.size() - pos != sizeof(bid.amount)) {
+        return false;
+    }
+    memcpy(&bid.amount, body.data() + pos, sizeof(bid.amount));
+    return true;
+}
+
+/**
+ * Define a class appending mutation records to a log file with group
+ * commit. Log() only copies the record into a buffer; a flusher thread
+ * writes the buffer and syncs it to disk every GROUP_COMMIT_MICROS (or
+ * sooner when it fills up or someone waits), so one sync covers every
+ * record logged since the last one. WaitDurable() blocks until a
+ * record is on disk. A failed write is final: the records queued behind
+ * it are dropped and nothing more is logged until the log is reopened.
+ */
+class WriteAheadLog {
+
+private:
+    FILE* file;
+    mutex lock;
+    condition_variable wake;      // wakes the flusher early
+    condition_variable durable;   // wakes callers waiting for a sync
+    string pending;               // records not yet written
+    uint64_t pendingLsn;          // last record in pending
+    uint64_t durableLsn;          // every record up to this one is on disk
+    long long loggedBytes;
+    bool syncRequested;
+    bool stopping;
+    bool failed;
+    thread flusher;
+
+    void flushLoop();
+
+public:
+    WriteAheadLog();
+    virtual ~WriteAheadLog();
+    bool Open(string path, bool truncate, uint64_t lastLsn);
+    void Close();
+    bool Log(uint64_t lsn, LogRecordType type, const Bid& bid);
+    bool WaitDurable(uint64_t lsn);
+    long long Bytes();
+};
+
+/**
+ * Default constructor
+ */
+WriteAheadLog::WriteAheadLog() {
+    file = nullptr;
+    pendingLsn = 0;
+    durableLsn = 0;
+    loggedBytes = 0;
+    syncRequested = false;
+    stopping = false;
+    failed = false;
+}
+
+/**
+ * Destructor, syncs anything still pending
+ */
+WriteAheadLog::~WriteAheadLog() {
+    Close();
+}
+
+/**
+ * Open the log file for appending and start the flusher
+ *
+ * @param path The log file
+ * @param truncate true to start the file over
+ * @param lastLsn The sequence number of the last record already logged
+ * @return false when the file can't be opened
+ */
+bool WriteAheadLog::Open(string path, bool truncate, uint64_t lastLsn) {
+    Close();
+    file = fopen(path.c_str(), truncate ? "wb" : "ab");
+    if (file == nullptr) {
+        cerr << "Failed to open " << path << endl;
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+
+    lock_guard<mutex> guard(lock);
+    loggedBytes = ftell(file);
+    pending.clear();
+    pendingLsn = lastLsn;
+    durableLsn = lastLsn;
+    syncRequested = false;
+    stopping = false;
+    failed = false;
+    flusher = thread(&WriteAheadLog::flushLoop, this);
+    return true;
+}
+
+/**
+ * Sync what is pending, stop the flusher and close the file
+ */
+void WriteAheadLog::Close() {
+    if (file == nullptr) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    flusher.join();
+
+    lock_guard<mutex> guard(lock);
+    fclose(file);
+    file = nullptr;
+}
+
+/**
+ * The flusher: gather records, write and sync them as one batch
+ */
+void WriteAheadLog::flushLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        wake.wait_for(guard, chrono::microseconds(GROUP_COMMIT_MICROS), [this]() {
+            return stopping || syncRequested || pending.size() >= GROUP_COMMIT_BYTES;
+        });
+        syncRequested = false;
+
+        //nothing is written after a failure, not even what was queued before it
+        if (failed) {
+            pending.clear();
+        }
+        if (pending.empty()) {
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+
+        //take the batch and write it without holding up Log()
+        string batch;
+        batch.swap(pending);
+        uint64_t batchLsn = pendingLsn;
+        guard.unlock();
+        bool written = fwrite(batch.data(), 1, batch.size(), file) == batch.size() && syncFile(file);
+        guard.lock();
+
+        if (written) {
+            durableLsn = batchLsn;
+        }
+        else {
+            failed = true;
+        }
+        durable.notify_all();
+    }
+}
+
+/**
+ * Queue a record for the next group commit
+ *
+ * @param lsn The record's sequence number, one more than the last
+ * @param type The mutation
+ * @param bid The bid appended or prepended, or holding the removed bidId
+ * @return false, queueing nothing, when the log isn't open or a write has failed
+ */
+bool WriteAheadLog::Log(uint64_t lsn, LogRecordType type, const Bid& bid) {
+    string record;
+    encodeLogRecord(record, lsn, type, bid);
+
+    lock_guard<mutex> guard(lock);
+    if (file == nullptr || failed) {
+        return false;
+    }
+    pending.append(record);
+    pendingLsn = lsn;
+    loggedBytes += record.size();
+    if (pending.size() >= GROUP_COMMIT_BYTES) {
+        wake.notify_one();
+    }
+    return true;
+}
+
+/**
+ * Wait until a record is on disk, asking the flusher to sync now
+ *
+ * @param lsn The record's sequence number
+ * @return false when writing the log has failed
+ */
+bool WriteAheadLog::WaitDurable(uint64_t lsn) {
+    unique_lock<mutex> guard(lock);
+    if (durableLsn >= lsn) {
+        return true;
+    }
+    if (file == nullptr) {
+        return false;
+    }
+    syncRequested = true;
+    wake.notify_one();
+    durable.wait(guard, [this, lsn]() {
+        return durableLsn >= lsn || failed;
+    });
+    return durableLsn >= lsn;
+}
+
+/**
+ * Returns the size the log file will have once pending records are written
+ */
+long long WriteAheadLog::Bytes() {
+    lock_guard<mutex> guard(lock);
+    return loggedBytes;
+}
+
+//============================================================================
+// Durable linked-list class definition
+//============================================================================
+
+/**
+ * Define a class with LinkedList's methods whose Append, Prepend and
+ * Remove are recorded in a write-ahead log before they are applied,
+ * so the list survives a restart. On construction the list is rebuilt
+ * from the last snapshot plus the log records written after it. When
+ * the log passes COMPACT_LOG_BYTES the whole list is written to a new
+ * snapshot and the log starts over.
+ *
+ * By default a mutation waits until its record is on disk before it is
+ * applied and returns; callers mutating at the same time share one
+ * sync. With asynchronous commit a mutation is applied and returns as
+ * soon as it is logged, and reaches the disk with the next group commit
+ * (within GROUP_COMMIT_MICROS), so a crash can lose the last few.
+ * Logged mutations are applied in log order either way.
+ *
+ * A mutation that fails to log or sync is not applied, but some of its
+ * records may still have reached the disk. The list then refuses every
+ * mutation until it has written a snapshot of its in-memory state and
+ * started the log over, so a restart can't replay a failed mutation.
+ */
+class DurableLinkedList {
+
+private:
+    LinkedList list;
+    WriteAheadLog wal;
+    string logPath;
+    string snapshotPath;
+    mutex listLock;               // guards list, lastLsn and appliedLsn
+    condition_variable applied;   // wakes mutations waiting for their turn
+    uint64_t lastLsn;             // last mutation logged
+    uint64_t appliedLsn;          // last mutation applied to list
+    bool asynchronous;
+    bool failed;                  // a mutation failed, the log must be compacted
+
+    void replay();
+    void apply(LogRecordType type, const Bid& bid);
+    bool commit(LogRecordType type, const Bid* bids, size_t count);
+    bool compact();
+
+public:
+    DurableLinkedList(string path);
+    DurableLinkedList(string path, bool asynchronousCommit);
+    virtual ~DurableLinkedList();
+    bool Append(Bid bid);
+    bool AppendAll(const vector<Bid>& bids);
+    bool Prepend(Bid bid);
+    void PrintList();
+    bool Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+    bool Sync();
+    bool Compact();
+};
+
+/**
+ * Constructor, replays the snapshot and log found at path
+ *
+ * @param path The log file; the snapshot is path + ".snapshot"
+ */
+DurableLinkedList::DurableLinkedList(string path) : list(true) {
+    logPath = path;
+    snapshotPath = path + ".snapshot";
+    lastLsn = 0;
+    appliedLsn = 0;
+    asynchronous = false;
+    failed = false;
+    replay();
+}
+
+/**
+ * Constructor choosing whether mutations return before they are on disk
+ */
+DurableLinkedList::DurableLinkedList(string path, bool asynchronousCommit) : DurableLinkedList(path) {
+    asynchronous = asynchronousCommit;
+}
+
+/**
+ * Destructor, the log syncs its pending records as it closes. After a
+ * failure the log is replaced by a snapshot instead, if it can be.
+ */
+DurableLinkedList::~DurableLinkedList() {
+    lock_guard<mutex> guard(listLock);
+    if (failed) {
+        compact();
+    }
+}
+
+/**
+ * Apply a mutation to the in-memory list without logging it
+ */
+void DurableLinkedList::apply(LogRecordType type, const Bid& bid) {
+    switch (type) {
+    case LOG_APPEND:
+        list.Append(bid);
+        break;
+    case LOG_PREPEND:
+        list.Prepend(bid);
+        break;
+    case LOG_REMOVE:
+        list.Remove(bid.bidId);
+        break;
+    }
+}
+
+/**
+ * Rebuild the list from the snapshot, then the log records newer than
+ * it, and reopen the log for appending
+ */
+void DurableLinkedList::replay() {
+    uint64_t lsn = 0;
+    LogRecordType type;
+    Bid bid;
+
+    FILE* snapshot = fopen(snapshotPath.c_str(), "rb");
+    if (snapshot != nullptr) {
+        uint32_t magic = 0;
+        if (fread(&magic, sizeof(magic), 1, snapshot) == 1 && magic == SNAPSHOT_MAGIC
+            && fread(&lastLsn, sizeof(lastLsn), 1, snapshot) == 1) {
+            uint64_t unused;
+            while (readLogRecord(snapshot, unused, type, bid)) {
+                list.Append(bid);
+            }
+        }
+        fclose(snapshot);
+    }
+
+    //records the snapshot already covers are skipped
+    bool tornTail = false;
+    FILE* log = fopen(logPath.c_str(), "rb");
+    if (log != nullptr) {
+        long goodBytes = 0;
+        while (readLogRecord(log, lsn, type, bid)) {
+            if (lsn > lastLsn) {
+                apply(type, bid);
+                lastLsn = lsn;
+            }
+            goodBytes = ftell(log);
+        }
+        fseek(log, 0, SEEK_END);
+        tornTail = ftell(log) != goodBytes;
+        fclose(log);
+    }
+    appliedLsn = lastLsn;
+
+    //a crash mid-write leaves a partial record; snapshot past it
+    if (tornTail) {
+        compact();
+    }
+    else {
+        wal.Open(logPath, false, lastLsn);
+    }
+}
+
+/**
+ * Log a run of mutations of one type, wait for them to reach the disk
+ * unless commit is asynchronous, then apply them once every earlier
+ * mutation has been applied. Compacts when the log has grown too long,
+ * or after a failure once nothing is in flight.
+ *
+ * @return false, leaving the list unchanged, when the log can't be written
+ */
+bool DurableLinkedList::commit(LogRecordType type, const Bid* bids, size_t count) {
+    uint64_t lsn;
+    size_t logged = 0;
+    {
+        unique_lock<mutex> guard(listLock);
+
+        //after a failure the log may hold records that were never applied
+        if (failed) {
+            applied.wait(guard, [this]() {
+                return appliedLsn == lastLsn;
+            });
+            if (failed && !compact()) {
+                return false;
+            }
+        }
+        while (logged < count && wal.Log(lastLsn + 1, type, bids[logged])) {
+            ++lastLsn;
+            ++logged;
+        }
+        lsn = lastLsn;
+    }
+    if (logged < count) {
+        cerr << "Failed to log to " << logPath << endl;
+    }
+    uint64_t first = lsn - logged + 1;
+
+    //everyone waiting here rides the same sync
+    bool durable = logged == count && (asynchronous || wal.WaitDurable(lsn));
+
+    unique_lock<mutex> guard(listLock);
+    if (!durable) {
+        failed = true;
+    }
+    if (logged > 0) {
+        applied.wait(guard, [this, first]() {
+            return appliedLsn == first - 1;
+        });
+        if (durable) {
+            for (size_t i = 0; i < count; ++i) {
+                apply(type, bids[i]);
+            }
+        }
+        appliedLsn = lsn;
+        applied.notify_all();
+    }
+
+    //the snapshot must hold every logged mutation, so only compact when none is in flight
+    if (appliedLsn == lastLsn && (failed || wal.Bytes() > COMPACT_LOG_BYTES)) {
+        compact();
+    }
+    return durable;
+}
+
+/**
+ * Append a new bid to the end of the list
+ *
+ * @return false when the mutation couldn't be logged
+ */
+bool DurableLinkedList::Append(Bid bid) {
+    return commit(LOG_APPEND, &bid, 1);
+}
+
+/**
+ * Append bids to the end of the list in order, logged as one batch so
+ * they share a single sync
+ *
+ * @return false when the mutations couldn't be logged
+ */
+bool DurableLinkedList::AppendAll(const vector<Bid>& bids) {
+    return bids.empty() || commit(LOG_APPEND, bids.data(), bids.size());
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ *
+ * @return false when the mutation couldn't be logged
+ */
+bool DurableLinkedList::Prepend(Bid bid) {
+    return commit(LOG_PREPEND, &bid, 1);
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void DurableLinkedList::PrintList() {
+    lock_guard<mutex> guard(listLock);
+    list.PrintList();
+}
+
+/**
+ * Remove a specified bid; nothing is logged when it isn't in the list
+ *
+ * @param bidId The bid id to remove from the list
+ * @return false when the bid wasn't found or couldn't be logged
+ */
+bool DurableLinkedList::Remove(string bidId) {
+    {
+        lock_guard<mutex> guard(listLock);
+        if (list.Search(bidId).bidId.empty()) {
+            return false;
+        }
+    }
+    Bid bid;
+    bid.bidId = bidId;
+    return commit(LOG_REMOVE, &bid, 1);
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid DurableLinkedList::Search(string bidId) {
+    lock_guard<mutex> guard(listLock);
+    return list.Search(bidId);
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int DurableLinkedList::Size() {
+    lock_guard<mutex> guard(listLock);
+    return list.Size();
+}
+
+/**
+ * Wait until every mutation so far is on disk
+ *
+ * @return false when writing the log has failed
+ */
+bool DurableLinkedList::Sync() {
+    uint64_t lsn;
+    {
+        lock_guard<mutex> guard(listLock);
+        if (failed) {
+            return false;
+        }
+        lsn = lastLsn;
+    }
+    return wal.WaitDurable(lsn);
+}
+
+/**
+ * Write the whole list to a new snapshot and start the log over, once
+ * every mutation logged so far has been applied
+ *
+ * @return false when the snapshot can't be written
+ */
+bool DurableLinkedList::Compact() {
+    unique_lock<mutex> guard(listLock);
+    applied.wait(guard, [this]() {
+        return appliedLsn == lastLsn;
+    });
+    return compact();
+}
+
+/**
+ * Write the whole list to a new snapshot and start the log over; the
+ * caller holds listLock with nothing in flight. The snapshot records
+ * the last sequence number it covers, so a crash between replacing the
+ * snapshot and emptying the log replays nothing twice, and no record of
+ * a failed mutation.
+ *
+ * @return false when the snapshot can't be written
+ */
+bool DurableLinkedList::compact() {
+    wal.Close();
+
+    string tempPath = snapshotPath + ".tmp";
+    FILE* snapshot = fopen(tempPath.c_str(), "wb");
+    if (snapshot == nullptr) {
+        cerr << "Failed to open " << tempPath << endl;
+        wal.Open(logPath, false, lastLsn);
+        return false;
+    }
+
+    //the snapshot is the list's bids in order, as append records
+    string buffer;
+    buffer.append(reinterpret_cast<const char*>(&SNAPSHOT_MAGIC), sizeof(SNAPSHOT_MAGIC));
+    buffer.append(reinterpret_cast<const char*>(&lastLsn), sizeof(lastLsn));
+    bool written = true;
+    list.ForEach([&](const Bid& bid) {
+        encodeLogRecord(buffer, 0, LOG_APPEND, bid);
+        if (buffer.size() >= GROUP_COMMIT_BYTES) {
+            written = written && fwrite(buffer.data(), 1, buffer.size(), snapshot) == buffer.size();
+            buffer.clear();
+        }
+    });
+    written = written && fwrite(buffer.data(), 1, buffer.size(), snapshot) == buffer.size();
+    written = syncFile(snapshot) && written;
+    fclose(snapshot);
+
+    //swap the snapshot in; Windows won't rename over an existing file
+#ifdef _WIN32
+    if (written) {
+        remove(snapshotPath.c_str());
+    }
+#endif
+    if (!written || rename(tempPath.c_str(), snapshotPath.c_str()) != 0) {
+        cerr << "Failed to write " << snapshotPath << endl;
+        remove(tempPath.c_str());
+        wal.Open(logPath, false, lastLsn);
+        return false;
+    }
+
+    if (!wal.Open(logPath, true, lastLsn)) {
+        return false;
+    }
+    failed = false;
+    return true;
+}
+
+//============================================================================
+// Static methods used for testing
+//============================================================================
+
+/**
+ * Display the bid information
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(Bid bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount
+         << " | " << bid.fund << endl;
+    return;
+}
+
+/**
+ * Prompt user for bid information
+ *
+ * @return Bid struct containing the bid info
+ */
+Bid getBid() {
+    Bid bid;
+
+    cout << "Enter Id: ";
+    cin.ignore();
+    getline(cin, bid.bidId);
+
+    cout << "Enter title: ";
+    getline(cin, bid.title);
+
+    cout << "Enter fund: ";
+    cin >> bid.fund;
+
+    cout << "Enter amount: ";
+    cin.ignore();
+    string strAmount;
+    getline(cin, strAmount);
+    bid.amount = strToDouble(strAmount, '$');
+
+    return bid;
+}
+
+/**
+ * Load a CSV file containing bids into a LinkedList
+ *
+ * @return a LinkedList containing all the bids read
+ */
+template <typename List>
+void loadBids(string csvPath, List *list) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser
+    csv::Parser file = csv::Parser(csvPath);
+
+    try {
+        // loop to read rows of a CSV file
+        for (int i = 0; i < file.rowCount(); i++) {
+
+            // initialize a bid using data from current row (i)
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][8];
+            bid.amount = strToDouble(file[i][4], '$');
+
+            //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
+
+            // add this bid to the end
+            list->Append(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Load a CSV file into a LinkedList. Each thread turns its share of the
+ * rows into a chain of its own, then the chains are spliced on in row
+ * order, touching tail and size once per chain instead of once per row.
+ * A worker that hits a bad row hands its error back to be reported here.
+ */
+void loadBids(string csvPath, LinkedList *list) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    try {
+        // initialize the CSV Parser
+        csv::Parser file = csv::Parser(csvPath);
+
+        unsigned int rows = file.rowCount();
+        unsigned int threadCount = max(1u, min(thread::hardware_concurrency(), rows / 1024 + 1));
+        unsigned int slice = (rows + threadCount - 1) / threadCount;
+        vector<LinkedList> chains(threadCount);
+        vector<exception_ptr> errors(threadCount);
+        vector<thread> threads;
+
+        // each thread builds a chain from its own slice of the rows
+        for (unsigned int t = 0; t < threadCount; ++t) {
+            unsigned int begin = min(rows, t * slice);
+            unsigned int end = min(rows, begin + slice);
+            threads.push_back(thread([&file, &chains, &errors, t, begin, end]() {
+                try {
+                    for (unsigned int i = begin; i < end; ++i) {
+                        Bid bid;
+                        bid.bidId = file[i][1];
+                        bid.title = file[i][0];
+                        bid.fund = file[i][8];
+                        bid.amount = strToDouble(file[i][4], '$');
+                        chains[t].Append(bid);
+                    }
+                } catch (csv::Error &) {
+                    errors[t] = current_exception();
+                }
+            }));
+        }
+        for (unsigned int t = 0; t < threadCount; ++t) {
+            threads[t].join();
+        }
+
+        // keep the rows before a bad one, as a single-threaded load would
+        for (unsigned int t = 0; t < threadCount; ++t) {
+            list->Splice(std::move(chains[t]));
+            if (errors[t]) {
+                rethrow_exception(errors[t]);
+            }
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+/**
+ * Load a CSV file into a ConcurrentLinkedList with one appending thread
+ * per core, so the bids from different threads interleave in the list
+ */
+void loadBids(string csvPath, ConcurrentLinkedList *list) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser
+    csv::Parser file = csv::Parser(csvPath);
+
+    vector<Bid> bids;
+    try {
+        for (unsigned int i = 0; i < file.rowCount(); i++) {
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][8];
+            bid.amount = strToDouble(file[i][4], '$');
+            bids.push_back(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+
+    // each thread appends its own slice of the rows
+    unsigned int threadCount = max(1u, thread::hardware_concurrency());
+    size_t slice = (bids.size() + threadCount - 1) / threadCount;
+    vector<thread> threads;
+    for (unsigned int t = 0; t < threadCount; ++t) {
+        size_t begin = min(bids.size(), t * slice);
+        size_t end = min(bids.size(), begin + slice);
+        threads.push_back(thread([list, &bids, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                list->Append(bids[i]);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+}
+
+/**
+ * Load a CSV file into a DurableLinkedList as one logged batch. A list
+ * that came back from its log already holds the file's bids, so it is
+ * left alone rather than loaded a second time.
+ */
+void loadBids(string csvPath, DurableLinkedList *list) {
+    if (list->Size() > 0) {
+        cout << list->Size() << " bids restored from the log, not loading " << csvPath << endl;
+        return;
+    }
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser
+    csv::Parser file = csv::Parser(csvPath);
+
+    vector<Bid> bids;
+    try {
+        for (unsigned int i = 0; i < file.rowCount(); i++) {
+            Bid bid;
+            bid.bidId = file[i][1];
+            bid.title = file[i][0];
+            bid.fund = file[i][8];
+            bid.amount = strToDouble(file[i][4], '$');
+            bids.push_back(bid);
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+    }
+
+    list->AppendAll(bids);
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * Sort a list by title, if it can be sorted
+ *
+ * @return false when the list keeps its own order
+ */
+template <typename List>
+bool sortBids(List&) {
+    return false;
+}
+
+/**
+ * Sort a LinkedList by title in place
+ */
+bool sortBids(LinkedList& bidList) {
+    bidList.Sort(SORT_BY_TITLE);
+    return true;
+}
+
+/**
+ * Run the menu against one list implementation
+ *
+ * @param bidList The list to enter, load, display, find and remove bids in
+ * @param csvPath path to CSV file to load from
+ * @param bidKey the bid Id to use when searching the list
+ */
+template <typename List>
+void runMenu(List& bidList, string csvPath, string bidKey) {
+    clock_t ticks;
+
+    Bid bid;
+
+    // looks single bids up straight from the file
+    BidCache bidCache(csvPath, BID_CACHE_CAPACITY);
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Enter a Bid" << endl;
+        cout << "  2. Load Bids" << endl;
+        cout << "  3. Display All Bids" << endl;
+        cout << "  4. Find Bid" << endl;
+        cout << "  5. Remove Bid" << endl;
+        cout << "  6. Sort Bids by Title" << endl;
+        cout << "  7. Find Bid in File (cached)" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+        case 1:
+            bid = getBid();
+            bidList.Append(bid);
+            displayBid(bid);
+
+            break;
+
+        case 2:
+            ticks = clock();
+
+            loadBids(csvPath, &bidList);
+
+            cout << bidList.Size() << " bids read" << endl;
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
             cout << "time: " << ticks << " milliseconds" << endl;
             cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
 
@@ -422,7 +2785,118 @@ int main(int argc, char* argv[]) {
             bidList.Remove(bidKey);
 
             break;
+
+        case 6:
+            ticks = clock();
+
+            if (sortBids(bidList)) {
+                cout << bidList.Size() << " bids sorted" << endl;
+            }
+            else {
+                cout << "This list keeps its own order." << endl;
+            }
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 7:
+            ticks = clock();
+
+            bid = bidCache.Get(bidKey);
+
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+
+            if (!bid.bidId.empty()) {
+                displayBid(bid);
+            } else {
+                cout << "Bid Id " << bidKey << " not found." << endl;
+            }
+
+            cout << "cache: " << bidCache.Hits() << " hits, " << bidCache.Misses() << " misses, "
+                 << bidCache.Evictions() << " evictions" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+        }
+    }
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional)
+ * @param arg[2] the bid Id to use when searching the list (optional)
+ * @param arg[3] the list to use, "linked", "indexed", "unrolled",
+ *               "concurrent", "skiplist" or "concurrent-skiplist" (a
+ *               skip list in concurrent-reader mode), a linked list
+ *               reordered by searches: "move-to-front", "transpose" or
+ *               "frequency", or
+ *               "durable", a linked list logged to arg[1] + ".wal", or
+ *               "durable-async", the same without waiting for each sync (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    // process command line arguments
+    string csvPath, bidKey, listType = "linked";
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        bidKey = "98109";
+        break;
+    case 3:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        break;
+    case 4:
+        csvPath = argv[1];
+        bidKey = argv[2];
+        listType = argv[3];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+        bidKey = "98109";
+    }
+
+    if (listType == "unrolled") {
+        UnrolledLinkedList bidList;
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else if (listType == "skiplist" || listType == "concurrent-skiplist") {
+        SkipList bidList(listType == "concurrent-skiplist");
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else if (listType == "concurrent") {
+        ConcurrentLinkedList bidList;
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else if (listType == "durable" || listType == "durable-async") {
+        DurableLinkedList bidList(csvPath + ".wal", listType == "durable-async");
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else if (listType == "indexed") {
+        LinkedList bidList(true);
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else if (listType == "move-to-front" || listType == "transpose" || listType == "frequency") {
+        LinkedList bidList;
+        if (listType == "move-to-front") {
+            bidList.SetSearchPolicy(SEARCH_MOVE_TO_FRONT);
         }
+        else if (listType == "transpose") {
+            bidList.SetSearchPolicy(SEARCH_TRANSPOSE);
+        }
+        else {
+            bidList.SetSearchPolicy(SEARCH_FREQUENCY_COUNT);
+        }
+        runMenu(bidList, csvPath, bidKey);
+    }
+    else {
+        LinkedList bidList;
+        runMenu(bidList, csvPath, bidKey);
     }
 
     cout << "Good bye." << endl;
@@ -0,0 +1,280 @@
+#ifndef     _NODEPOOL_HPP_
+# define    _NODEPOOL_HPP_
+
+# include <cstddef>
+# include <new>
+# include <utility>
+# include <vector>
+
+//============================================================================
+// Slab allocator for fixed-size container nodes
+//============================================================================
+
+// bytes in one slab, the same for every node type so slabs can be reused
+const std::size_t NODE_POOL_SLAB_BYTES = 64 * 1024;
+
+// empty slabs a thread keeps for its next pool instead of freeing them
+const std::size_t NODE_POOL_CACHED_SLABS = 64;
+
+/**
+ * Per-thread cache of empty slabs shared by every NodePool on the thread.
+ * A container torn down and rebuilt (reloading a CSV, say) gets its slabs
+ * back from here instead of from the heap.
+ */
+class SlabCache {
+
+private:
+    std::vector<void*> slabs;
+
+    ~SlabCache();
+    static SlabCache* local();
+
+public:
+    static void* Acquire();
+    static void Release(void* slab);
+};
+
+// set once a thread's cache is destroyed; plain bool so it outlives it
+inline bool& slabCacheClosed() {
+    static thread_local bool closed = false;
+    return closed;
+}
+
+/**
+ * Destructor, frees the cached slabs when the thread exits
+ */
+inline SlabCache::~SlabCache() {
+    for (void* slab : slabs) {
+        ::operator delete(slab);
+    }
+    slabCacheClosed() = true;
+}
+
+/**
+ * The calling thread's cache, or nullptr once it has been destroyed
+ * (a pool outliving its thread's cache frees straight to the heap)
+ */
+inline SlabCache* SlabCache::local() {
+    if (slabCacheClosed()) {
+        return nullptr;
+    }
+    static thread_local SlabCache cache;
+    return &cache;
+}
+
+/**
+ * Take an empty slab from the cache, or the heap when it's empty
+ */
+inline void* SlabCache::Acquire() {
+    SlabCache* cache = local();
+    if (cache != nullptr && !cache->slabs.empty()) {
+        void* slab = cache->slabs.back();
+        cache->slabs.pop_back();
+        return slab;
+    }
+    return ::operator new(NODE_POOL_SLAB_BYTES);
+}
+
+/**
+ * Give an empty slab back, keeping up to NODE_POOL_CACHED_SLABS of them
+ */
+inline void SlabCache::Release(void* slab) {
+    SlabCache* cache = local();
+    if (cache != nullptr && cache->slabs.size() < NODE_POOL_CACHED_SLABS) {
+        cache->slabs.push_back(slab);
+    }
+    else {
+        ::operator delete(slab);
+    }
+}
+
+/**
+ * Define a class handing out nodes of one type from large slabs.
+ * New() reuses a freed node or bumps a pointer through the newest slab,
+ * so nodes allocated together sit next to each other in memory.
+ * Delete() destroys a node and puts it on the free list.
+ * The pool's destructor (or Release()) returns whole slabs at once, so
+ * freeing a container's memory costs one step per slab, not per node.
+ *
+ * A pool belongs to one container and is not thread safe.
+ */
+template <typename T>
+class NodePool {
+
+private:
+    // a free slot holds the free list link, a used one holds a T
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "node type is over-aligned for a slab");
+    static_assert(sizeof(Slot) <= NODE_POOL_SLAB_BYTES, "node type is larger than a slab");
+
+    std::vector<void*> slabs;
+    Slot* freeList;
+    Slot* bump;      // next never used slot in the newest slab
+    Slot* bumpEnd;   // end of the newest slab
+    std::size_t live;
+
+    Slot* allocate();
+
+public:
+    NodePool();
+    virtual ~NodePool();
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    template <typename... Args>
+    T* New(Args&&... args);
+    void Delete(T* node);
+    void Adopt(NodePool& other);
+    void Release();
+    std::size_t Size();
+    std::size_t SlabCount();
+};
+
+/**
+ * Default constructor
+ */
+template <typename T>
+NodePool<T>::NodePool() {
+    freeList = nullptr;
+    bump = nullptr;
+    bumpEnd = nullptr;
+    live = 0;
+}
+
+/**
+ * Destructor, returns every slab
+ */
+template <typename T>
+NodePool<T>::~NodePool() {
+    Release();
+}
+
+/**
+ * Find a slot for a new node: a freed one first, then the newest slab,
+ * then a fresh slab
+ */
+template <typename T>
+typename NodePool<T>::Slot* NodePool<T>::allocate() {
+    if (freeList != nullptr) {
+        Slot* slot = freeList;
+        freeList = slot->next;
+        return slot;
+    }
+    if (bump == bumpEnd) {
+        void* slab = SlabCache::Acquire();
+        slabs.push_back(slab);
+        bump = static_cast<Slot*>(slab);
+        bumpEnd = bump + NODE_POOL_SLAB_BYTES / sizeof(Slot);
+    }
+    return bump++;
+}
+
+/**
+ * Construct a node in the pool
+ *
+ * @param args The node's constructor arguments
+ * @return the new node
+ */
+template <typename T>
+template <typename... Args>
+T* NodePool<T>::New(Args&&... args) {
+    Slot* slot = allocate();
+    try {
+        T* node = new (slot->storage) T(std::forward<Args>(args)...);
+        ++live;
+        return node;
+    }
+    catch (...) {
+        // the constructor threw, hand the slot straight back
+        slot->next = freeList;
+        freeList = slot;
+        throw;
+    }
+}
+
+/**
+ * Destroy a node and keep its slot for the next New()
+ *
+ * @param node A node from this pool
+ */
+template <typename T>
+void NodePool<T>::Delete(T* node) {
+    if (node == nullptr) {
+        return;
+    }
+    node->~T();
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = freeList;
+    freeList = slot;
+    --live;
+}
+
+/**
+ * Take over another pool's slabs and nodes, so nodes it handed out can
+ * move into this pool's container without being copied. The other pool
+ * is left empty. Slots it never used in its newest slab stay unused
+ * until the slabs are released.
+ *
+ * @param other The pool to empty into this one
+ */
+template <typename T>
+void NodePool<T>::Adopt(NodePool& other) {
+    if (&other == this) {
+        return;
+    }
+    slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+
+    //chain the other pool's free slots in front of ours
+    if (other.freeList != nullptr) {
+        Slot* last = other.freeList;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = freeList;
+        freeList = other.freeList;
+    }
+    live += other.live;
+
+    other.slabs.clear();
+    other.freeList = nullptr;
+    other.bump = nullptr;
+    other.bumpEnd = nullptr;
+    other.live = 0;
+}
+
+/**
+ * Return every slab at once. Nodes still in the pool are not destroyed,
+ * so the owner deletes them first unless T has nothing to destroy.
+ */
+template <typename T>
+void NodePool<T>::Release() {
+    for (void* slab : slabs) {
+        SlabCache::Release(slab);
+    }
+    slabs.clear();
+    freeList = nullptr;
+    bump = nullptr;
+    bumpEnd = nullptr;
+    live = 0;
+}
+
+/**
+ * Returns the number of live nodes in the pool
+ */
+template <typename T>
+std::size_t NodePool<T>::Size() {
+    return live;
+}
+
+/**
+ * Returns the number of slabs the pool holds
+ */
+template <typename T>
+std::size_t NodePool<T>::SlabCount() {
+    return slabs.size();
+}
+
+#endif /*!_NODEPOOL_HPP_*/
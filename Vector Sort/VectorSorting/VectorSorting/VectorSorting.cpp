@@ -7,9 +7,41 @@
 //============================================================================
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
 #include <time.h>
 
+// AVX2 sorting kernels are compiled for x86 and picked at run time
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define BID_SIMD_X86
+#define AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BID_SIMD_X86
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+// the benchmark reads the hardware cache-miss counter where Linux offers it
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "CSVparser.hpp"
 
 using namespace std;
@@ -32,6 +64,70 @@ struct Bid {
     }
 };
 
+// the bid fields a collection of bids can be ordered on
+enum SortKey {
+    SORT_BY_TITLE,
+    SORT_BY_ID,
+    SORT_BY_AMOUNT,
+    SORT_BY_FUND
+};
+
+/**
+ * Compare two bids on the given sort key
+ *
+ * Bid ids are compared by length first so that numeric ids
+ * order numerically ("999" before "1000").
+ *
+ * @param a the left hand bid
+ * @param b the right hand bid
+ * @param key the field to compare on
+ * @return true if a orders strictly before b
+ */
+bool bidLess(const Bid& a, const Bid& b, SortKey key) {
+    switch (key) {
+    case SORT_BY_ID:
+        if (a.bidId.size() != b.bidId.size()) {
+            return a.bidId.size() < b.bidId.size();
+        }
+        return a.bidId < b.bidId;
+    case SORT_BY_AMOUNT:
+        return a.amount < b.amount;
+    case SORT_BY_FUND:
+        return a.fund < b.fund;
+    default:
+        return a.title < b.title;
+    }
+}
+
+// comparison and swap totals collected while the benchmark runs a sort
+struct SortCounters {
+    long long comparisons;
+    long long swaps;   // element swaps, or moves for the merge-based sorts
+
+    SortCounters() {
+        comparisons = 0;
+        swaps = 0;
+    }
+};
+
+// function object wrapper so bidLess can be handed to the standard algorithms
+struct BidLess {
+    SortKey key;
+    SortCounters* counters;   // only set while benchmarking
+
+    BidLess(SortKey aKey, SortCounters* someCounters = nullptr) {
+        key = aKey;
+        counters = someCounters;
+    }
+
+    bool operator()(const Bid& a, const Bid& b) const {
+        if (counters != nullptr) {
+            ++counters->comparisons;
+        }
+        return bidLess(a, b, key);
+    }
+};
+
 //============================================================================
 // Static methods used for testing
 //============================================================================
@@ -119,26 +215,31 @@ vector<Bid> loadBids(string csvPath) {
  * @param bids Address of the vector<Bid> instance to be partitioned
  * @param begin Beginning index to partition
  * @param end Ending index to partition
+ * @param counters optional comparison and swap totals for the benchmark
  */
-int partition(vector<Bid>& bids, int begin, int end) {
+int partition(vector<Bid>& bids, int begin, int end, SortCounters* counters = nullptr) {
+    // compares titles, counting when the benchmark asks for it
+    BidLess less(SORT_BY_TITLE, counters);
+
     // set low and high equal to the first and last indices.
     int low = begin;        // Starting point of the low index
     int high = end;         // Starting point of the high index
 
-    // picking the pivot point (the middle element of the range).
-    int pivot = begin + (end - begin) / 2;
+    // picking the pivot point (the middle element of the range). Keep a copy,
+    // the swaps below can move the element away from the middle index.
+    Bid pivot = bids.at(begin + (end - begin) / 2);
 
     // Flag to indicate when the partition is complete and exits the loop.
     bool done = false;
 
     while (!done) {
         //Increment the low index as long as the title is less than the pivot title.
-        while (bids.at(low).title.compare(bids.at(pivot).title) < 0) {
+        while (less(bids.at(low), pivot)) {
             ++low;
         }
 
         //Decrement the high index as long as the title at the high is greater than the pivot title.
-        while (bids.at(pivot).title.compare(bids.at(high).title) < 0) {
+        while (less(pivot, bids.at(high))) {
             --high;
         }
 
@@ -149,6 +250,9 @@ int partition(vector<Bid>& bids, int begin, int end) {
         else {
             //Swap the elements at the low and the high pointers.
             swap(bids.at(low), bids.at(high));
+            if (counters != nullptr) {
+                ++counters->swaps;
+            }
 
             //Move the pointers toward each other (low to the right, high to the left)
             ++low;
@@ -172,8 +276,9 @@ int partition(vector<Bid>& bids, int begin, int end) {
  * @param bids address of the vector<Bid> instance to be sorted
  * @param begin the beginning index to sort on
  * @param end the ending index to sort on
+ * @param counters optional comparison and swap totals for the benchmark
  */
-void quickSort(vector<Bid>& bids, int begin, int end) {
+void quickSort(vector<Bid>& bids, int begin, int end, SortCounters* counters = nullptr) {
     // Initialize 'mid' to hold the pivot index after partitioning.
     int mid = 0;  
 
@@ -182,12 +287,12 @@ void quickSort(vector<Bid>& bids, int begin, int end) {
         return;
     }
     // Partition the array and get the pivot index.
-    mid = partition(bids, begin, end);  
+    mid = partition(bids, begin, end, counters);
 
      // Recursively sort the left partition (elements smaller than the pivot).
-    quickSort(bids, begin, mid); 
+    quickSort(bids, begin, mid, counters);
     // Recursively sort the right partition (elements larger than the pivot).
-    quickSort(bids, mid + 1, end);  
+    quickSort(bids, mid + 1, end, counters);
 }
 
 // FIXME (1a): Implement the selection sort logic over bid.title
@@ -199,8 +304,12 @@ void quickSort(vector<Bid>& bids, int begin, int end) {
  *
  * @param bid address of the vector<Bid>
  *            instance to be sorted
+ * @param counters optional comparison and swap totals for the benchmark
  */
-void selectionSort(vector<Bid>& bids) {
+void selectionSort(vector<Bid>& bids, SortCounters* counters = nullptr) {
+    // compares titles, counting when the benchmark asks for it
+    BidLess less(SORT_BY_TITLE, counters);
+
     // Define min as the index of the current minimum bid
     int min = 0;
 
@@ -216,7 +325,7 @@ void selectionSort(vector<Bid>& bids) {
         // Loop over the remaining elements to the right of position pos
         for (size_t j = pos + 1; j < size; ++j) {
             // If this element's title is less than the current minimum title
-            if (bids[j].title < bids[min].title) {
+            if (less(bids[j], bids[min])) {
                 // This element becomes the new minimum
                 min = j;
             }
@@ -225,120 +334,2285 @@ void selectionSort(vector<Bid>& bids) {
         // Swap the current minimum with the smaller one found
         if (min != pos) {
             swap(bids[min], bids[pos]);  // Swap using the built-in vector method
+            if (counters != nullptr) {
+                ++counters->swaps;
+            }
         }
     }
 }
 
+// runs shorter than this are extended with insertion sort before merging
+const size_t MIN_MERGE_RUN = 32;
 
 /**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
+ * Scratch space for mergeSort and sortBids. Keep one around and pass it to every
+ * call: once it has grown to the largest vector sorted, later sorts
+ * allocate nothing.
+ */
+struct MergeSortBuffer {
+    vector<Bid> bids;      // holds the left run while it is merged
+    vector<size_t> runs;   // run boundaries found in the input
+
+    // (key, index) pairs and their scratch for the numeric sorts
+    vector<int64_t> keys;
+    vector<int64_t> indices;
+    vector<int64_t> keyScratch;
+    vector<int64_t> indexScratch;
+    vector<size_t> radixCounts;
+};
+
+/**
+ * Stable binary insertion sort of bids[begin, end) where
+ * bids[begin, sorted) is already in order
+ */
+void insertionSortRun(vector<Bid>& bids, size_t begin, size_t sorted, size_t end,
+        const BidLess& less) {
+    for (size_t i = sorted; i < end; ++i) {
+        // insert after any equal keys to keep the sort stable
+        size_t pos = upper_bound(bids.begin() + begin, bids.begin() + i, bids[i], less)
+                - bids.begin();
+        if (pos != i) {
+            Bid moving = move(bids[i]);
+            move_backward(bids.begin() + pos, bids.begin() + i, bids.begin() + i + 1);
+            bids[pos] = move(moving);
+            if (less.counters != nullptr) {
+                less.counters->swaps += i - pos + 2;
+            }
+        }
+    }
+}
+
+/**
+ * Merge the adjacent sorted runs bids[begin, mid) and bids[mid, end)
+ * by moving only the left run out to the scratch buffer.
+ */
+void mergeRuns(vector<Bid>& bids, size_t begin, size_t mid, size_t end,
+        vector<Bid>& scratch, const BidLess& less) {
+    // the runs are already in order, typical for appended daily files
+    if (!less(bids[mid], bids[mid - 1])) {
+        return;
+    }
+
+    // left bids no larger than the first right bid are already in place
+    begin = upper_bound(bids.begin() + begin, bids.begin() + mid, bids[mid], less)
+            - bids.begin();
+
+    // move what is left of the left run out of the way
+    size_t leftSize = mid - begin;
+    move(bids.begin() + begin, bids.begin() + mid, scratch.begin());
+
+    // merge back into place, taking from the left on ties for stability
+    size_t left = 0;
+    size_t right = mid;
+    size_t out = begin;
+    while (left < leftSize && right < end) {
+        if (less(bids[right], scratch[left])) {
+            bids[out++] = move(bids[right++]);
+        }
+        else {
+            bids[out++] = move(scratch[left++]);
+        }
+    }
+    // any right bids left over are already in place
+    move(scratch.begin() + left, scratch.begin() + leftSize, bids.begin() + out);
+    if (less.counters != nullptr) {
+        less.counters->swaps += 2 * leftSize + (right - mid);
+    }
+}
+
+/**
+ * Perform a stable natural merge sort on a bid key
+ * Existing ascending runs (and strictly descending runs, which are
+ * reversed) are detected first, so already or mostly sorted input such
+ * as appended daily files sorts in close to linear time. Runs are then
+ * merged pairwise, bottom-up.
+ * Best case performance: O(n)
+ * Worst case performance: O(n log(n))
  *
- * credit: http://stackoverflow.com/a/24875936
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param buffer scratch space reused across calls
+ * @param key the field to sort on
+ * @param counters optional comparison and move totals for the benchmark
+ */
+void mergeSort(vector<Bid>& bids, MergeSortBuffer& buffer, SortKey key = SORT_BY_TITLE,
+        SortCounters* counters = nullptr) {
+    size_t size = bids.size();
+    if (size < 2) {
+        return;
+    }
+    BidLess less(key, counters);
+
+    // only grows, so repeated sorts of the same data allocate nothing
+    if (buffer.bids.size() < size) {
+        buffer.bids.resize(size);
+    }
+
+    // find the natural runs, extending short ones to MIN_MERGE_RUN
+    vector<size_t>& runs = buffer.runs;
+    runs.clear();
+    runs.push_back(0);
+    size_t begin = 0;
+    while (begin < size) {
+        size_t end = begin + 1;
+        if (end < size && less(bids[end], bids[begin])) {
+            // strictly descending, reversing it cannot swap equal keys
+            while (end < size && less(bids[end], bids[end - 1])) {
+                ++end;
+            }
+            reverse(bids.begin() + begin, bids.begin() + end);
+            if (counters != nullptr) {
+                counters->swaps += (end - begin) / 2;
+            }
+        }
+        else {
+            while (end < size && !less(bids[end], bids[end - 1])) {
+                ++end;
+            }
+        }
+
+        if (end - begin < MIN_MERGE_RUN && end < size) {
+            size_t extended = min(size, begin + MIN_MERGE_RUN);
+            insertionSortRun(bids, begin, end, extended, less);
+            end = extended;
+        }
+        runs.push_back(end);
+        begin = end;
+    }
+
+    // merge neighbouring runs pairwise until a single run is left
+    while (runs.size() > 2) {
+        size_t kept = 1;
+        size_t i = 0;
+        for (; i + 2 < runs.size(); i += 2) {
+            mergeRuns(bids, runs[i], runs[i + 1], runs[i + 2], buffer.bids, less);
+            runs[kept++] = runs[i + 2];
+        }
+        // an odd run out is carried to the next pass as is
+        if (i + 1 < runs.size()) {
+            runs[kept++] = runs[i + 1];
+        }
+        runs.resize(kept);
+    }
+}
+
+//============================================================================
+// SIMD sorting kernels for numeric bid keys
+//============================================================================
+
+// numeric keys are sorted in blocks of this many before the merge phase
+const size_t SIMD_SORT_BLOCK = 16;
+
+// pairs sorted completely in cache before merging across memory; keys,
+// indices and their scratch for one chunk take 128 KiB
+const size_t CACHE_SORT_CHUNK = 4096;
+
+/**
+ * Map an amount onto an int64 with the same ordering (sign-flip trick):
+ * positive doubles already order like their bit patterns, negative ones
+ * order backwards, so their magnitude bits are flipped.
+ */
+int64_t amountSortKey(double amount) {
+    // fold -0.0 into 0.0 so the two compare equal like they do as doubles
+    if (amount == 0.0) {
+        amount = 0.0;
+    }
+    int64_t bits;
+    memcpy(&bits, &amount, sizeof(bits));
+    return bits ^ ((bits >> 63) & INT64_MAX);
+}
+
+/**
+ * Parse a bid id as an int64 sort key. Only plain digit strings without
+ * leading zeros are accepted, because only those order numerically the
+ * same way bidLess orders them.
  *
- * @param ch The character to strip out
+ * @return false if the id can't be sorted numerically
  */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+bool bidIdSortKey(const string& bidId, int64_t& key) {
+    if (bidId.empty() || bidId.size() > 18 || (bidId[0] == '0' && bidId.size() > 1)) {
+        return false;
+    }
+    key = 0;
+    for (size_t i = 0; i < bidId.size(); ++i) {
+        if (bidId[i] < '0' || bidId[i] > '9') {
+            return false;
+        }
+        key = key * 10 + (bidId[i] - '0');
+    }
+    return true;
 }
 
 /**
- * The one and only main() method
+ * Order (key, index) pairs by key, then by index. Indices are unique,
+ * so sorting pairs this way is deterministic and stable.
  */
-int main(int argc, char* argv[]) {
+inline bool pairLess(int64_t keyA, int64_t indexA, int64_t keyB, int64_t indexB) {
+    // bitwise operators so the compiler emits flag arithmetic, not branches
+    return (keyA < keyB) | ((keyA == keyB) & (indexA < indexB));
+}
 
-    // process command line arguments
-    string csvPath;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
+/**
+ * Insertion sort for a short run of (key, index) pairs
+ */
+void insertionSortPairs(int64_t* keys, int64_t* indices, size_t count) {
+    for (size_t i = 1; i < count; ++i) {
+        int64_t key = keys[i];
+        int64_t index = indices[i];
+        size_t j = i;
+        while (j > 0 && pairLess(key, index, keys[j - 1], indices[j - 1])) {
+            keys[j] = keys[j - 1];
+            indices[j] = indices[j - 1];
+            --j;
+        }
+        keys[j] = key;
+        indices[j] = index;
     }
+}
 
-    // Define a vector to hold all the bids
-    vector<Bid> bids;
+/**
+ * Merge two sorted runs of (key, index) pairs into the output arrays
+ */
+void mergePairs(const int64_t* keysA, const int64_t* indicesA, size_t countA,
+        const int64_t* keysB, const int64_t* indicesB, size_t countB,
+        int64_t* keysOut, int64_t* indicesOut) {
+    size_t a = 0;
+    size_t b = 0;
+    size_t out = 0;
+    // branch-free: the comparison picks the source with conditional moves
+    while (a < countA && b < countB) {
+        bool takeB = pairLess(keysB[b], indicesB[b], keysA[a], indicesA[a]);
+        keysOut[out] = takeB ? keysB[b] : keysA[a];
+        indicesOut[out++] = takeB ? indicesB[b] : indicesA[a];
+        b += takeB;
+        a += !takeB;
+    }
+    for (; a < countA; ++a, ++out) {
+        keysOut[out] = keysA[a];
+        indicesOut[out] = indicesA[a];
+    }
+    for (; b < countB; ++b, ++out) {
+        keysOut[out] = keysB[b];
+        indicesOut[out] = indicesB[b];
+    }
+}
 
-    // Define a timer variable
-    clock_t ticks;
+#ifdef BID_SIMD_X86
 
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Load Bids" << endl;
-        cout << "  2. Display All Bids" << endl;
-        cout << "  3. Selection Sort All Bids" << endl;
-        cout << "  4. Quick Sort All Bids" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
+/**
+ * Check once whether this CPU (and the OS) supports AVX2
+ */
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // the OS must save the YMM registers for AVX to be usable
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+            && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
 
-        switch (choice) {
+/**
+ * Compare-exchange four lanes at once: a keeps the smaller key of every
+ * lane and b the larger. Indices move with their keys. Only keys are
+ * compared to keep the networks short, so equal keys may come out with
+ * their indices out of order; sortKeyIndexPairs puts them back.
+ */
+AVX2_TARGET inline void compareExchange(__m256i& keysA, __m256i& indicesA,
+        __m256i& keysB, __m256i& indicesB) {
+    __m256i swapLanes = _mm256_cmpgt_epi64(keysA, keysB);
+    __m256i minKeys = _mm256_blendv_epi8(keysA, keysB, swapLanes);
+    __m256i maxKeys = _mm256_blendv_epi8(keysB, keysA, swapLanes);
+    __m256i minIndices = _mm256_blendv_epi8(indicesA, indicesB, swapLanes);
+    __m256i maxIndices = _mm256_blendv_epi8(indicesB, indicesA, swapLanes);
+    keysA = minKeys;
+    keysB = maxKeys;
+    indicesA = minIndices;
+    indicesB = maxIndices;
+}
 
-        case 1:
-            // Initialize a timer variable before loading bids
-            ticks = clock();
+/**
+ * Compare-exchange lanes of one register with the lanes selected by
+ * the permute control. The swap decision is made on the lower lane of
+ * every pair and mirrored to its partner, so equal keys never duplicate.
+ * A macro because the permute control has to be a compile-time immediate.
+ */
+#define EXCHANGE_WITHIN(keys, indices, control, upperLanes) \
+    { \
+        __m256i partnerKeys = _mm256_permute4x64_epi64(keys, control); \
+        __m256i partnerIndices = _mm256_permute4x64_epi64(indices, control); \
+        __m256i swapLower = _mm256_cmpgt_epi64(keys, partnerKeys); \
+        __m256i swapPair = _mm256_blend_epi32(swapLower, \
+                _mm256_permute4x64_epi64(swapLower, control), upperLanes); \
+        keys = _mm256_blendv_epi8(keys, partnerKeys, swapPair); \
+        indices = _mm256_blendv_epi8(indices, partnerIndices, swapPair); \
+    }
 
-            // Complete the method call to load the bids
-            bids = loadBids(csvPath);
+/**
+ * Finish a bitonic merge inside one register: compare-exchange lanes
+ * two apart, then neighbouring lanes, leaving the four lanes sorted.
+ */
+AVX2_TARGET inline void bitonicCleanup(__m256i& keys, __m256i& indices) {
+    // lanes two apart: 0 with 2, 1 with 3
+    EXCHANGE_WITHIN(keys, indices, 0x4E, 0xF0);
 
-            cout << bids.size() << " bids read" << endl;
+    // neighbouring lanes: 0 with 1, 2 with 3
+    EXCHANGE_WITHIN(keys, indices, 0xB1, 0xCC);
+}
 
-            // Calculate elapsed time and display result
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+/**
+ * Bitonic merge of two sorted registers: afterwards a holds the four
+ * smallest pairs and b the four largest, both sorted.
+ */
+AVX2_TARGET inline void bitonicMerge(__m256i& keysA, __m256i& indicesA,
+        __m256i& keysB, __m256i& indicesB) {
+    // reversing b turns a followed by b into a bitonic sequence
+    keysB = _mm256_permute4x64_epi64(keysB, 0x1B);
+    indicesB = _mm256_permute4x64_epi64(indicesB, 0x1B);
+    compareExchange(keysA, indicesA, keysB, indicesB);
+    bitonicCleanup(keysA, indicesA);
+    bitonicCleanup(keysB, indicesB);
+}
 
-            break;
+/**
+ * Transpose a 4x4 block of 64-bit lanes held in four registers
+ */
+AVX2_TARGET inline void transpose4x4(__m256i& row0, __m256i& row1, __m256i& row2, __m256i& row3) {
+    __m256i low01 = _mm256_unpacklo_epi64(row0, row1);
+    __m256i high01 = _mm256_unpackhi_epi64(row0, row1);
+    __m256i low23 = _mm256_unpacklo_epi64(row2, row3);
+    __m256i high23 = _mm256_unpackhi_epi64(row2, row3);
+    row0 = _mm256_permute2x128_si256(low01, low23, 0x20);
+    row1 = _mm256_permute2x128_si256(high01, high23, 0x20);
+    row2 = _mm256_permute2x128_si256(low01, low23, 0x31);
+    row3 = _mm256_permute2x128_si256(high01, high23, 0x31);
+}
 
-        case 2:
-            // Loop and display the bids read
-            for (int i = 0; i < bids.size(); ++i) {
-                displayBid(bids[i]);
+/**
+ * Sort 16 (key, index) pairs entirely in registers: a sorting network
+ * across four registers sorts every column, a transpose turns the
+ * columns into sorted runs of four, and two rounds of bitonic merges
+ * combine them.
+ */
+AVX2_TARGET void sortBlockAvx2(int64_t* keys, int64_t* indices) {
+    __m256i k0 = _mm256_loadu_si256((const __m256i*)(keys + 0));
+    __m256i k1 = _mm256_loadu_si256((const __m256i*)(keys + 4));
+    __m256i k2 = _mm256_loadu_si256((const __m256i*)(keys + 8));
+    __m256i k3 = _mm256_loadu_si256((const __m256i*)(keys + 12));
+    __m256i i0 = _mm256_loadu_si256((const __m256i*)(indices + 0));
+    __m256i i1 = _mm256_loadu_si256((const __m256i*)(indices + 4));
+    __m256i i2 = _mm256_loadu_si256((const __m256i*)(indices + 8));
+    __m256i i3 = _mm256_loadu_si256((const __m256i*)(indices + 12));
+
+    // optimal 4-input sorting network, applied to all four columns at once
+    compareExchange(k0, i0, k1, i1);
+    compareExchange(k2, i2, k3, i3);
+    compareExchange(k0, i0, k2, i2);
+    compareExchange(k1, i1, k3, i3);
+    compareExchange(k1, i1, k2, i2);
+
+    // sorted columns become sorted rows
+    transpose4x4(k0, k1, k2, k3);
+    transpose4x4(i0, i1, i2, i3);
+
+    // two runs of 4 into one run of 8, twice
+    bitonicMerge(k0, i0, k1, i1);
+    bitonicMerge(k2, i2, k3, i3);
+
+    // two runs of 8 into 16: reverse the second run, split, then clean up
+    __m256i r2 = _mm256_permute4x64_epi64(k3, 0x1B);
+    __m256i r3 = _mm256_permute4x64_epi64(k2, 0x1B);
+    __m256i ri2 = _mm256_permute4x64_epi64(i3, 0x1B);
+    __m256i ri3 = _mm256_permute4x64_epi64(i2, 0x1B);
+    compareExchange(k0, i0, r2, ri2);
+    compareExchange(k1, i1, r3, ri3);
+    compareExchange(k0, i0, k1, i1);
+    compareExchange(r2, ri2, r3, ri3);
+    bitonicCleanup(k0, i0);
+    bitonicCleanup(k1, i1);
+    bitonicCleanup(r2, ri2);
+    bitonicCleanup(r3, ri3);
+
+    _mm256_storeu_si256((__m256i*)(keys + 0), k0);
+    _mm256_storeu_si256((__m256i*)(keys + 4), k1);
+    _mm256_storeu_si256((__m256i*)(keys + 8), r2);
+    _mm256_storeu_si256((__m256i*)(keys + 12), r3);
+    _mm256_storeu_si256((__m256i*)(indices + 0), i0);
+    _mm256_storeu_si256((__m256i*)(indices + 4), i1);
+    _mm256_storeu_si256((__m256i*)(indices + 8), ri2);
+    _mm256_storeu_si256((__m256i*)(indices + 12), ri3);
+}
+
+/**
+ * Merge two sorted runs four pairs at a time. A register holding the
+ * four largest pairs seen so far is merged with the next four pairs of
+ * whichever run has the smaller head; the lower four are final. The last
+ * few pairs are finished with a scalar three-way merge.
+ */
+AVX2_TARGET void mergePairsAvx2(const int64_t* keysA, const int64_t* indicesA, size_t countA,
+        const int64_t* keysB, const int64_t* indicesB, size_t countB,
+        int64_t* keysOut, int64_t* indicesOut) {
+    if (countA < 4 || countB < 4) {
+        mergePairs(keysA, indicesA, countA, keysB, indicesB, countB, keysOut, indicesOut);
+        return;
+    }
+
+    __m256i lowKeys = _mm256_loadu_si256((const __m256i*)keysA);
+    __m256i lowIndices = _mm256_loadu_si256((const __m256i*)indicesA);
+    __m256i highKeys = _mm256_loadu_si256((const __m256i*)keysB);
+    __m256i highIndices = _mm256_loadu_si256((const __m256i*)indicesB);
+    size_t a = 4;
+    size_t b = 4;
+    size_t out = 0;
+
+    bitonicMerge(lowKeys, lowIndices, highKeys, highIndices);
+    _mm256_storeu_si256((__m256i*)(keysOut + out), lowKeys);
+    _mm256_storeu_si256((__m256i*)(indicesOut + out), lowIndices);
+    out += 4;
+
+    while (a + 4 <= countA && b + 4 <= countB) {
+        // pick the next source without a branch, the outcome is random
+        bool takeA = pairLess(keysA[a], indicesA[a], keysB[b], indicesB[b]);
+        const int64_t* nextKeys = takeA ? keysA + a : keysB + b;
+        const int64_t* nextIndices = takeA ? indicesA + a : indicesB + b;
+        a += takeA ? 4 : 0;
+        b += takeA ? 0 : 4;
+        lowKeys = _mm256_loadu_si256((const __m256i*)nextKeys);
+        lowIndices = _mm256_loadu_si256((const __m256i*)nextIndices);
+        bitonicMerge(lowKeys, lowIndices, highKeys, highIndices);
+        _mm256_storeu_si256((__m256i*)(keysOut + out), lowKeys);
+        _mm256_storeu_si256((__m256i*)(indicesOut + out), lowIndices);
+        out += 4;
+    }
+
+    // the held register and what is left of both runs, merged in scalar
+    int64_t heldKeys[4];
+    int64_t heldIndices[4];
+    _mm256_storeu_si256((__m256i*)heldKeys, highKeys);
+    _mm256_storeu_si256((__m256i*)heldIndices, highIndices);
+    size_t held = 0;
+    while (out < countA + countB) {
+        int source = 0;
+        int64_t key = 0;
+        int64_t index = 0;
+        if (held < 4) {
+            source = 1;
+            key = heldKeys[held];
+            index = heldIndices[held];
+        }
+        if (a < countA && (source == 0 || pairLess(keysA[a], indicesA[a], key, index))) {
+            source = 2;
+            key = keysA[a];
+            index = indicesA[a];
+        }
+        if (b < countB && (source == 0 || pairLess(keysB[b], indicesB[b], key, index))) {
+            source = 3;
+            key = keysB[b];
+            index = indicesB[b];
+        }
+        keysOut[out] = key;
+        indicesOut[out++] = index;
+        if (source == 1) {
+            ++held;
+        }
+        else if (source == 2) {
+            ++a;
+        }
+        else {
+            ++b;
+        }
+    }
+}
+
+#endif
+
+/**
+ * Merge sorted runs of the given width, doubling the width every pass
+ * and ping-ponging between the arrays and the scratch until one run is
+ * left. The result always ends up back in keys and indices.
+ */
+void mergePairPasses(int64_t* keys, int64_t* indices, size_t count, size_t width,
+        int64_t* keyScratch, int64_t* indexScratch, bool useAvx2) {
+    int64_t* fromKeys = keys;
+    int64_t* fromIndices = indices;
+    int64_t* toKeys = keyScratch;
+    int64_t* toIndices = indexScratch;
+    for (; width < count; width *= 2) {
+        for (size_t begin = 0; begin < count; begin += 2 * width) {
+            size_t mid = min(begin + width, count);
+            size_t end = min(begin + 2 * width, count);
+#ifdef BID_SIMD_X86
+            if (useAvx2) {
+                mergePairsAvx2(fromKeys + begin, fromIndices + begin, mid - begin,
+                        fromKeys + mid, fromIndices + mid, end - mid,
+                        toKeys + begin, toIndices + begin);
+                continue;
             }
-            cout << endl;
+#endif
+            mergePairs(fromKeys + begin, fromIndices + begin, mid - begin,
+                    fromKeys + mid, fromIndices + mid, end - mid,
+                    toKeys + begin, toIndices + begin);
+        }
+        swap(fromKeys, toKeys);
+        swap(fromIndices, toIndices);
+    }
 
-            break;
+    // an odd number of passes leaves the result in the scratch
+    if (fromKeys != keys) {
+        copy(fromKeys, fromKeys + count, keys);
+        copy(fromIndices, fromIndices + count, indices);
+    }
+}
 
-        // FIXME (1b): Invoke the selection sort and report timing results
-        case 3:
-            //Initialize a timer variable before loading the bids.
-            ticks = clock();
+/**
+ * Sort parallel arrays of int64 keys and indices by (key, index).
+ * Blocks of SIMD_SORT_BLOCK pairs are sorted in registers with AVX2
+ * sorting networks when the CPU has it (insertion sort otherwise).
+ * The blocks are merged into cache-sized chunks while the chunk is
+ * still in cache, and only then are the chunks merged across memory.
+ * Sorting 16-byte pairs and moving each bid once at the end is much
+ * cheaper than swapping whole Bid structs during the sort.
+ * Performance: O(n log(n)), stable with respect to the starting indices
+ *
+ * @param keys the sort keys
+ * @param indices the payload moved along with each key
+ * @param count number of pairs
+ * @param keyScratch scratch space for count keys
+ * @param indexScratch scratch space for count indices
+ */
+void sortKeyIndexPairs(int64_t* keys, int64_t* indices, size_t count,
+        int64_t* keyScratch, int64_t* indexScratch) {
+#ifdef BID_SIMD_X86
+    static const bool useAvx2 = cpuHasAvx2();
+#else
+    const bool useAvx2 = false;
+#endif
+
+    for (size_t chunk = 0; chunk < count; chunk += CACHE_SORT_CHUNK) {
+        size_t chunkSize = min(CACHE_SORT_CHUNK, count - chunk);
+
+        // sort every block, the short tail block with insertion sort
+        for (size_t begin = chunk; begin < chunk + chunkSize; begin += SIMD_SORT_BLOCK) {
+            size_t blockSize = min(SIMD_SORT_BLOCK, chunk + chunkSize - begin);
+#ifdef BID_SIMD_X86
+            if (useAvx2 && blockSize == SIMD_SORT_BLOCK) {
+                sortBlockAvx2(keys + begin, indices + begin);
+                continue;
+            }
+#endif
+            insertionSortPairs(keys + begin, indices + begin, blockSize);
+        }
 
-            //Call the SelectionSort method to load the bids;
-            selectionSort(bids);
+        // merge the blocks while the chunk is still in cache
+        mergePairPasses(keys + chunk, indices + chunk, chunkSize, SIMD_SORT_BLOCK,
+                keyScratch + chunk, indexScratch + chunk, useAvx2);
+    }
 
-            //Displays how the size of bids to the screen.
-            cout << bids.size() << " bids sorted" << endl;
+    // then merge the sorted chunks across memory
+    mergePairPasses(keys, indices, count, CACHE_SORT_CHUNK, keyScratch, indexScratch, useAvx2);
 
-            //Calculate the elapsed time and displays the results to the screen.
-            ticks = clock() - ticks;
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    // the SIMD networks ignore indices, so order them within equal keys
+    if (useAvx2) {
+        for (size_t begin = 0; begin < count;) {
+            size_t end = begin + 1;
+            while (end < count && keys[end] == keys[begin]) {
+                ++end;
+            }
+            if (end - begin > 1) {
+                sort(indices + begin, indices + end);
+            }
+            begin = end;
+        }
+    }
+}
 
-            break;
-        
-         // FIXME (2b): Invoke the quick sort and report timing results
-        case 4:
-            // Start a timer variable before loading the bids.
-            ticks = clock();
+//============================================================================
+// LSD radix sort for numeric bid keys
+//============================================================================
 
-            //Call the QuickSort method to load the bids.
-            quickSort(bids, 0, bids.size() - 1);
+// bits sorted per radix pass, 6 passes cover a 64-bit key
+const int RADIX_BITS = 11;
+const size_t RADIX_BUCKETS = (size_t)1 << RADIX_BITS;
+const int RADIX_PASSES = (64 + RADIX_BITS - 1) / RADIX_BITS;
 
-            //Displays the size of bids to the screen.
-            cout << bids.size() << " bids sorted" << endl;
+// below this many bids the radix histograms cost more than they save
+const size_t RADIX_SORT_THRESHOLD = 1024;
 
-            //Calculate the elapsed time and display the results to the screen.
-            ticks = clock() - ticks;
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+// keys needing this many radix passes (raw doubles, wide ids) sort
+// faster with the AVX2 merge sort between these sizes, where the radix
+// scatter no longer fits in cache but the merges still stream well
+const int SIMD_WIDE_KEY_PASSES = 5;
+const size_t SIMD_WIDE_KEY_MIN = (size_t)1 << 18;
+const size_t SIMD_WIDE_KEY_MAX = (size_t)1 << 21;
 
-            break;
-        
+/**
+ * Convert every amount to whole cents when that is exact, which keeps
+ * the keys small enough for most radix passes to be skipped.
+ *
+ * @return false if some amount isn't a whole number of cents
+ */
+bool amountCentsKeys(const vector<Bid>& bids, int64_t* keys) {
+    for (size_t i = 0; i < bids.size(); ++i) {
+        double amount = bids[i].amount;
+        if (!(amount > -9.0e15 && amount < 9.0e15)) {
+            return false;
+        }
+        int64_t cents = llround(amount * 100.0);
+        if ((double)cents / 100.0 != amount) {
+            return false;
+        }
+        keys[i] = cents;
+    }
+    return true;
+}
+
+/**
+ * Perform a least-significant-digit radix sort on (key, index) pairs
+ * All digit histograms are counted in one read of the keys, and passes
+ * where every key has the same digit are skipped, so keys that span few
+ * bits (bid ids, amounts in cents) take only two or three passes.
+ * Each pass is a stable scatter, so equal keys keep their index order.
+ * Performance: O(n) per pass, at most RADIX_PASSES passes
+ *
+ * @param keys the sort keys
+ * @param indices the payload moved along with each key
+ * @param count number of pairs
+ * @param keyScratch scratch space for count keys
+ * @param indexScratch scratch space for count indices
+ * @param counts scratch space for the digit histograms
+ */
+void radixSortPairs(int64_t* keys, int64_t* indices, size_t count,
+        int64_t* keyScratch, int64_t* indexScratch, vector<size_t>& counts) {
+    // nothing to sort, and the passes below read the first key
+    if (count < 2) {
+        return;
+    }
+
+    // flipping the sign bit makes signed keys order as unsigned
+    const uint64_t signBit = (uint64_t)1 << 63;
 
+    counts.assign(RADIX_PASSES * RADIX_BUCKETS, 0);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = (uint64_t)keys[i] ^ signBit;
+        for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+            ++counts[pass * RADIX_BUCKETS + ((key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1))];
+        }
+    }
+
+    int64_t* fromKeys = keys;
+    int64_t* fromIndices = indices;
+    int64_t* toKeys = keyScratch;
+    int64_t* toIndices = indexScratch;
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        size_t* histogram = &counts[pass * RADIX_BUCKETS];
+        int shift = pass * RADIX_BITS;
+
+        // nothing to do if every key has the same digit in this pass
+        uint64_t firstDigit = (((uint64_t)fromKeys[0] ^ signBit) >> shift) & (RADIX_BUCKETS - 1);
+        if (histogram[firstDigit] == count) {
+            continue;
+        }
+
+        // turn the histogram into the starting offset of every bucket
+        size_t offset = 0;
+        for (size_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+            size_t bucketSize = histogram[digit];
+            histogram[digit] = offset;
+            offset += bucketSize;
+        }
+
+        // scatter in input order, which keeps the pass stable
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t digit = (((uint64_t)fromKeys[i] ^ signBit) >> shift) & (RADIX_BUCKETS - 1);
+            size_t target = histogram[digit]++;
+            toKeys[target] = fromKeys[i];
+            toIndices[target] = fromIndices[i];
+        }
+        swap(fromKeys, toKeys);
+        swap(fromIndices, toIndices);
+    }
+
+    // an odd number of passes leaves the result in the scratch
+    if (fromKeys != keys) {
+        copy(fromKeys, fromKeys + count, keys);
+        copy(fromIndices, fromIndices + count, indices);
+    }
+}
+
+/**
+ * Count the radix passes that will actually move keys: a pass is
+ * skipped when every key has the same digit in it.
+ */
+int radixPassCount(const int64_t* keys, size_t count) {
+    uint64_t varying = 0;
+    for (size_t i = 1; i < count; ++i) {
+        varying |= (uint64_t)keys[i] ^ (uint64_t)keys[0];
+    }
+    int passes = 0;
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        if ((varying >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)) {
+            ++passes;
+        }
+    }
+    return passes;
+}
+
+/**
+ * Choose between radix sort and the SIMD merge sort for count keys, by
+ * crossovers measured on an AVX2 machine: the merge sort wins on
+ * small inputs, and with AVX2 also on mid-sized inputs whose keys need
+ * most of the radix passes. Radix sort wins everywhere else.
+ */
+bool radixSortPays(const int64_t* keys, size_t count) {
+    if (count < RADIX_SORT_THRESHOLD) {
+        return false;
+    }
+#ifdef BID_SIMD_X86
+    static const bool useAvx2 = cpuHasAvx2();
+    if (useAvx2 && count >= SIMD_WIDE_KEY_MIN && count < SIMD_WIDE_KEY_MAX) {
+        return radixPassCount(keys, count) < SIMD_WIDE_KEY_PASSES;
+    }
+#endif
+    return true;
+}
+
+// which numeric sort sortBids runs; the benchmark forces each in turn
+enum NumericSortPath {
+    NUMERIC_SORT_AUTO,
+    NUMERIC_SORT_RADIX,
+    NUMERIC_SORT_SIMD
+};
+
+/**
+ * Sort the bids on any key. Amounts and numeric bid ids are sorted as
+ * (int64 key, index) pairs and the bids are then moved into place once.
+ * The numeric path is picked automatically by radixSortPays: radix sort
+ * for most inputs, the SIMD kernels for small ones and for mid-sized
+ * ones with wide keys. Titles, funds and ids that aren't
+ * plain numbers fall back to mergeSort. Either way the sort is stable.
+ * Performance: O(n) for numeric keys, O(n log(n)) otherwise
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param buffer scratch space reused across calls
+ * @param key the field to sort on
+ * @param path the numeric sort to use, picked by radixSortPays by default
+ */
+void sortBids(vector<Bid>& bids, MergeSortBuffer& buffer, SortKey key,
+        NumericSortPath path = NUMERIC_SORT_AUTO) {
+    size_t size = bids.size();
+    if (key != SORT_BY_AMOUNT && key != SORT_BY_ID) {
+        mergeSort(bids, buffer, key);
+        return;
+    }
+    if (size < 2) {
+        return;
+    }
+
+    // only grows, so repeated sorts of the same data allocate nothing
+    if (buffer.keys.size() < size) {
+        buffer.keys.resize(size);
+        buffer.indices.resize(size);
+        buffer.keyScratch.resize(size);
+        buffer.indexScratch.resize(size);
+    }
+
+    // extract the numeric keys next to each bid's position, amounts
+    // as whole cents when possible and as raw doubles otherwise
+    bool inCents = key == SORT_BY_AMOUNT && amountCentsKeys(bids, buffer.keys.data());
+    for (size_t i = 0; i < size; ++i) {
+        if (key == SORT_BY_AMOUNT) {
+            if (!inCents) {
+                buffer.keys[i] = amountSortKey(bids[i].amount);
+            }
+        }
+        else if (!bidIdSortKey(bids[i].bidId, buffer.keys[i])) {
+            mergeSort(bids, buffer, key);
+            return;
+        }
+        buffer.indices[i] = (int64_t)i;
+    }
+
+    bool radix = path == NUMERIC_SORT_AUTO ? radixSortPays(buffer.keys.data(), size)
+            : path == NUMERIC_SORT_RADIX;
+    if (radix) {
+        radixSortPairs(buffer.keys.data(), buffer.indices.data(), size,
+                buffer.keyScratch.data(), buffer.indexScratch.data(), buffer.radixCounts);
+    }
+    else {
+        sortKeyIndexPairs(buffer.keys.data(), buffer.indices.data(), size,
+                buffer.keyScratch.data(), buffer.indexScratch.data());
+    }
+
+    // move every bid to its sorted position once
+    if (buffer.bids.size() < size) {
+        buffer.bids.resize(size);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        buffer.bids[i] = move(bids[buffer.indices[i]]);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        bids[i] = move(buffer.bids[i]);
+    }
+}
+
+//============================================================================
+// External merge sort for bid files larger than memory
+//============================================================================
+
+// in-memory budget for one sorted run before it is spilled to disk
+const size_t DEFAULT_RUN_BYTES = 64 * 1024 * 1024;
+
+// size of the buffer behind every run file and the output file
+const size_t IO_BUFFER_SIZE = 1024 * 1024;
+
+// most runs merged in a single pass, bounds open files and buffer memory
+const size_t MAX_MERGE_FAN_IN = 64;
+
+// the layouts the external sort can write its output in
+enum BidFileFormat {
+    CSV_FORMAT,
+    BINARY_FORMAT
+};
+
+/**
+ * Write one length-prefixed string field to a binary stream
+ */
+void writeField(ostream& out, const string& field) {
+    uint32_t length = (uint32_t)field.size();
+    out.write((const char*)&length, sizeof(length));
+    out.write(field.data(), length);
+}
+
+/**
+ * Read one length-prefixed string field from a binary stream
+ *
+ * @return false at end of stream
+ */
+bool readField(istream& in, string& field) {
+    uint32_t length = 0;
+    if (!in.read((char*)&length, sizeof(length))) {
+        return false;
+    }
+    field.resize(length);
+    return length == 0 || (bool)in.read(&field[0], length);
+}
+
+/**
+ * Write a bid in the compact binary record format used by the run files:
+ * id, title and fund as length-prefixed strings followed by the raw
+ * amount, all in native byte order.
+ *
+ * @param out the binary stream to write to
+ * @param bid the bid to write
+ */
+void writeBidRecord(ostream& out, const Bid& bid) {
+    writeField(out, bid.bidId);
+    writeField(out, bid.title);
+    writeField(out, bid.fund);
+    out.write((const char*)&bid.amount, sizeof(bid.amount));
+}
+
+/**
+ * Read the next bid written by writeBidRecord
+ *
+ * @param in the binary stream to read from
+ * @param bid receives the bid read
+ * @return false at end of stream
+ */
+bool readBidRecord(istream& in, Bid& bid) {
+    return readField(in, bid.bidId)
+        && readField(in, bid.title)
+        && readField(in, bid.fund)
+        && (bool)in.read((char*)&bid.amount, sizeof(bid.amount));
+}
+
+/**
+ * Read the next bid from a CSV stream one line at a time, so the whole
+ * file never has to be held in memory. Fields are split exactly the way
+ * csv::Parser splits them (on commas outside of quotes).
+ *
+ * @param in the CSV stream, positioned after the header row
+ * @param bid receives the bid read
+ * @return false at end of stream
+ */
+bool readCsvBid(istream& in, Bid& bid) {
+    string line;
+    vector<string> fields;
+
+    while (getline(in, line)) {
+        // tolerate files saved with Windows line endings
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // csv::Parser skips blank lines as well
+        if (line.empty()) {
+            continue;
+        }
+
+        // split the row on commas that are not inside quotes
+        fields.clear();
+        bool quoted = false;
+        size_t tokenStart = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '"') {
+                quoted = !quoted;
+            }
+            else if (line[i] == ',' && !quoted) {
+                fields.push_back(line.substr(tokenStart, i - tokenStart));
+                tokenStart = i + 1;
+            }
+        }
+        fields.push_back(line.substr(tokenStart));
+
+        if (fields.size() < 9) {
+            throw csv::Error("corrupted data !");
+        }
+
+        // same columns loadBids reads
+        bid.bidId = fields[1];
+        bid.title = fields[0];
+        bid.fund = fields[8];
+        bid.amount = strToDouble(fields[4], '$');
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Write a bid to the sorted output in the requested format. CSV fields
+ * are written back exactly as they were read, so quoted titles stay quoted.
+ */
+void writeBid(ostream& out, const Bid& bid, BidFileFormat format) {
+    if (format == BINARY_FORMAT) {
+        writeBidRecord(out, bid);
+    }
+    else {
+        out << bid.title << "," << bid.bidId << "," << bid.fund << ","
+            << bid.amount << "\n";
+    }
+}
+
+/**
+ * Open a file stream behind a large buffer so reads and writes
+ * hit the disk in big sequential chunks.
+ * The buffer must outlive the stream, so declare it first.
+ */
+template <typename Stream>
+bool openBuffered(Stream& stream, vector<char>& buffer, const string& path,
+        ios_base::openmode mode) {
+    buffer.resize(IO_BUFFER_SIZE);
+    stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    stream.open(path, mode);
+    return stream.is_open();
+}
+
+/**
+ * A sorted run file being consumed by the k-way merge
+ */
+struct BidRunReader {
+    vector<char> buffer;
+    ifstream in;
+    Bid current;
+    bool exhausted;
+
+    BidRunReader() {
+        exhausted = true;
+    }
+
+    // move to the next bid in the run
+    void advance() {
+        exhausted = !readBidRecord(in, current);
+    }
+};
+
+/**
+ * Define a class implementing a loser tree (tournament tree) over k
+ * sorted runs. Every internal node remembers the loser of the match
+ * played there and the overall winner sits at tree[0], so replacing the
+ * winner costs exactly one comparison per level: O(log k) per bid.
+ */
+class BidLoserTree {
+
+private:
+    vector<unique_ptr<BidRunReader>>& runs;
+    vector<size_t> tree;
+    SortKey key;
+
+    bool beats(size_t a, size_t b) const;
+
+public:
+    BidLoserTree(vector<unique_ptr<BidRunReader>>& someRuns, SortKey aKey);
+    size_t Winner() const;
+    void Replay();
+};
+
+/**
+ * Build the tree by playing every match bottom-up. Leaves live at
+ * k..2k-1 and internal nodes at 1..k-1, which works for any k.
+ */
+BidLoserTree::BidLoserTree(vector<unique_ptr<BidRunReader>>& someRuns, SortKey aKey) :
+        runs(someRuns) {
+    key = aKey;
+    size_t k = runs.size();
+    tree.assign(k, 0);
+
+    // winners of each match, only needed while building
+    vector<size_t> winners(2 * k);
+    for (size_t node = 2 * k - 1; node >= k; --node) {
+        winners[node] = node - k;
+    }
+    for (size_t node = k - 1; node >= 1; --node) {
+        size_t left = winners[2 * node];
+        size_t right = winners[2 * node + 1];
+        if (beats(left, right)) {
+            winners[node] = left;
+            tree[node] = right;
+        }
+        else {
+            winners[node] = right;
+            tree[node] = left;
+        }
+    }
+    tree[0] = winners[1];
+}
+
+/**
+ * Decide a match between two runs. Exhausted runs always lose and ties
+ * go to the earlier run, which keeps the merge stable.
+ */
+bool BidLoserTree::beats(size_t a, size_t b) const {
+    if (runs[a]->exhausted) {
+        return false;
+    }
+    if (runs[b]->exhausted) {
+        return true;
+    }
+    if (bidLess(runs[a]->current, runs[b]->current, key)) {
+        return true;
+    }
+    if (bidLess(runs[b]->current, runs[a]->current, key)) {
+        return false;
+    }
+    return a < b;
+}
+
+/**
+ * Index of the run holding the smallest current bid
+ */
+size_t BidLoserTree::Winner() const {
+    return tree[0];
+}
+
+/**
+ * Replay the path from the winner's leaf to the root after the
+ * winning run has advanced to its next bid.
+ */
+void BidLoserTree::Replay() {
+    size_t winner = tree[0];
+    for (size_t node = (winner + runs.size()) / 2; node >= 1; node /= 2) {
+        if (beats(tree[node], winner)) {
+            swap(tree[node], winner);
+        }
+    }
+    tree[0] = winner;
+}
+
+/**
+ * Merge sorted run files into a single sorted stream using a loser tree
+ *
+ * @param runPaths the run files to merge, in the order they were written
+ * @param out the stream receiving the merged bids
+ * @param format the layout to write each bid in
+ * @param key the field the runs are sorted on
+ * @return the number of bids written, or -1 if a run could not be opened
+ */
+long long mergeBidRuns(const vector<string>& runPaths, ostream& out,
+        BidFileFormat format, SortKey key) {
+    // open every run behind its own large read buffer
+    vector<unique_ptr<BidRunReader>> runs;
+    for (size_t i = 0; i < runPaths.size(); ++i) {
+        unique_ptr<BidRunReader> run(new BidRunReader());
+        if (!openBuffered(run->in, run->buffer, runPaths[i], ios::in | ios::binary)) {
+            cerr << "Failed to open " << runPaths[i] << endl;
+            return -1;
+        }
+        run->advance();
+        runs.push_back(move(run));
+    }
+
+    // repeatedly emit the winner and replay its path
+    long long count = 0;
+    BidLoserTree tree(runs, key);
+    while (!runs[tree.Winner()]->exhausted) {
+        BidRunReader* winner = runs[tree.Winner()].get();
+        writeBid(out, winner->current, format);
+        ++count;
+        winner->advance();
+        tree.Replay();
+    }
+    return count;
+}
+
+/**
+ * Delete spilled run files
+ */
+void removeRunFiles(const vector<string>& runPaths) {
+    for (size_t i = 0; i < runPaths.size(); ++i) {
+        remove(runPaths[i].c_str());
+    }
+}
+
+/**
+ * Sort a CSV file of bids that may be larger than memory.
+ * Bids are read in runs that fit the memory budget, each run is stably
+ * sorted with sortBids (radix sort for numeric keys) and spilled to a temporary binary file, then the runs are
+ * k-way merged (in several passes when there are more than
+ * MAX_MERGE_FAN_IN of them) and streamed to the output file.
+ * Average performance: O(n log(n)) comparisons, O(n log_k(runs)) I/O
+ *
+ * @param csvPath the path to the CSV file to sort
+ * @param outputPath the path the sorted bids are written to
+ * @param format write the output as CSV or as binary records
+ * @param key the field to sort on
+ * @param runBytes memory budget for a single in-memory run
+ * @return the number of bids written, or -1 on an I/O error
+ */
+long long externalSortBids(string csvPath, string outputPath,
+        BidFileFormat format = CSV_FORMAT, SortKey key = SORT_BY_TITLE,
+        size_t runBytes = DEFAULT_RUN_BYTES) {
+    cout << "External sorting CSV file " << csvPath << endl;
+
+    vector<char> inBuffer;
+    ifstream in;
+    if (!openBuffered(in, inBuffer, csvPath, ios::in)) {
+        cerr << "Failed to open " << csvPath << endl;
+        return -1;
+    }
+
+    // skip the header row
+    string header;
+    getline(in, header);
+
+    vector<string> runPaths;
+    vector<Bid> run;
+    MergeSortBuffer sortBuffer;
+    int runNumber = 0;
+
+    try {
+        // fill, sort and spill runs until the input is exhausted
+        Bid bid;
+        bool more = readCsvBid(in, bid);
+        while (more) {
+            size_t usedBytes = 0;
+            run.clear();
+            while (more && usedBytes < runBytes) {
+                usedBytes += sizeof(Bid) + bid.bidId.size() + bid.title.size()
+                        + bid.fund.size();
+                run.push_back(bid);
+                more = readCsvBid(in, bid);
+            }
+            sortBids(run, sortBuffer, key);
+
+            // the whole file fit in one run, nothing to merge
+            if (!more && runPaths.empty()) {
+                break;
+            }
+
+            string runPath = outputPath + ".run" + to_string(runNumber++);
+            vector<char> runBuffer;
+            ofstream runFile;
+            if (!openBuffered(runFile, runBuffer, runPath, ios::out | ios::binary | ios::trunc)) {
+                cerr << "Failed to open " << runPath << endl;
+                removeRunFiles(runPaths);
+                return -1;
+            }
+            for (size_t i = 0; i < run.size(); ++i) {
+                writeBidRecord(runFile, run[i]);
+            }
+            runPaths.push_back(runPath);
+            if (!runFile.flush()) {
+                cerr << "Failed to write " << runPath << endl;
+                runFile.close();
+                removeRunFiles(runPaths);
+                return -1;
+            }
+            run.clear();
+        }
+    } catch (csv::Error &e) {
+        std::cerr << e.what() << std::endl;
+
+        // don't leave spilled runs behind for a file that can't be sorted
+        removeRunFiles(runPaths);
+        return -1;
+    }
+
+    // merge passes until the remaining runs fit in a single merge
+    while (runPaths.size() > MAX_MERGE_FAN_IN) {
+        vector<string> mergedPaths;
+        for (size_t first = 0; first < runPaths.size(); first += MAX_MERGE_FAN_IN) {
+            size_t last = min(first + MAX_MERGE_FAN_IN, runPaths.size());
+            vector<string> group(runPaths.begin() + first, runPaths.begin() + last);
+
+            string mergedPath = outputPath + ".run" + to_string(runNumber++);
+            vector<char> mergedBuffer;
+            ofstream merged;
+            mergedPaths.push_back(mergedPath);
+            if (!openBuffered(merged, mergedBuffer, mergedPath, ios::out | ios::binary | ios::trunc)
+                    || mergeBidRuns(group, merged, BINARY_FORMAT, key) < 0 || !merged.flush()) {
+                cerr << "Failed to merge into " << mergedPath << endl;
+
+                // this pass's outputs so far, and every run not yet merged
+                merged.close();
+                removeRunFiles(mergedPaths);
+                removeRunFiles(vector<string>(runPaths.begin() + first, runPaths.end()));
+                return -1;
+            }
+            removeRunFiles(group);
+        }
+        runPaths = mergedPaths;
+    }
+
+    // stream the final merge (or the single in-memory run) to the output
+    vector<char> outBuffer;
+    ofstream out;
+    ios_base::openmode mode = ios::out | ios::trunc;
+    if (format == BINARY_FORMAT) {
+        mode |= ios::binary;
+    }
+    if (!openBuffered(out, outBuffer, outputPath, mode)) {
+        cerr << "Failed to open " << outputPath << endl;
+        removeRunFiles(runPaths);
+        return -1;
+    }
+    if (format == CSV_FORMAT) {
+        out << fixed << setprecision(2);
+        out << "Auction Title,Auction ID,Fund,Winning Bid\n";
+    }
+
+    long long count = 0;
+    if (runPaths.empty()) {
+        for (size_t i = 0; i < run.size(); ++i) {
+            writeBid(out, run[i], format);
+        }
+        count = (long long)run.size();
+    }
+    else {
+        count = mergeBidRuns(runPaths, out, format, key);
+        removeRunFiles(runPaths);
+    }
+
+    // a full disk shows up as a failed write or flush
+    if (!out.flush()) {
+        cerr << "Failed to write " << outputPath << endl;
+        return -1;
+    }
+    return count;
+}
+
+//============================================================================
+// Top-K selection by any bid key
+//============================================================================
+
+// below this many bids a top-K query runs on the calling thread only
+const size_t PARALLEL_SELECT_THRESHOLD = 1 << 16;
+
+/**
+ * Define a function object ranking bid indices for a top-K query.
+ * An index ranks first when its bid is better on the key (larger for
+ * top-K, smaller for bottom-K); ties go to the earlier bid so results
+ * are deterministic.
+ */
+struct BidRank {
+    const vector<Bid>* bids;
+    SortKey key;
+    bool largest;
+
+    BidRank(const vector<Bid>& someBids, SortKey aKey, bool wantLargest) {
+        bids = &someBids;
+        key = aKey;
+        largest = wantLargest;
+    }
+
+    bool operator()(size_t a, size_t b) const {
+        const Bid& bidA = (*bids)[a];
+        const Bid& bidB = (*bids)[b];
+        if (largest ? bidLess(bidB, bidA, key) : bidLess(bidA, bidB, key)) {
+            return true;
+        }
+        if (largest ? bidLess(bidA, bidB, key) : bidLess(bidB, bidA, key)) {
+            return false;
+        }
+        return a < b;
+    }
+};
+
+/**
+ * Offer one bid index to a bounded heap holding the best k seen so far.
+ * The heap front is the worst of the kept bids, so most bids are
+ * rejected with a single comparison and a replacement costs O(log k).
+ */
+void offerToHeap(vector<size_t>& heap, size_t k, size_t index, const BidRank& rank) {
+    if (heap.size() < k) {
+        heap.push_back(index);
+        push_heap(heap.begin(), heap.end(), rank);
+    }
+    else if (rank(index, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), rank);
+        heap.back() = index;
+        push_heap(heap.begin(), heap.end(), rank);
+    }
+}
+
+/**
+ * Select the k best bids on a key without sorting the whole vector.
+ * The vector is split into one chunk per thread, every chunk keeps its
+ * own bounded heap, and the per-chunk candidates are reduced through one
+ * more bounded heap.
+ * Performance: O(n log(k)) comparisons, O(k) extra memory per thread
+ *
+ * @param bids the bids to select from, left untouched
+ * @param k how many bids to return
+ * @param key the field to rank on
+ * @param largest true for the k largest (top-K), false for the k smallest
+ * @param threads worker threads to use, 0 for one per hardware thread
+ *                (or just the caller's below PARALLEL_SELECT_THRESHOLD bids)
+ * @return up to k bids, best first
+ */
+vector<Bid> selectTopBids(const vector<Bid>& bids, size_t k, SortKey key,
+        bool largest = true, unsigned int threads = 0) {
+    vector<Bid> result;
+    if (k == 0 || bids.empty()) {
+        return result;
+    }
+
+    BidRank rank(bids, key, largest);
+
+    // by default small inputs are not worth the thread start-up cost;
+    // an explicit thread count is used as given
+    if (threads == 0) {
+        threads = bids.size() < PARALLEL_SELECT_THRESHOLD ? 1 : thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // every chunk keeps its own bounded heap of candidates
+    vector<vector<size_t>> candidates(threads);
+    vector<thread> workers;
+    size_t chunkSize = (bids.size() + threads - 1) / threads;
+    for (unsigned int t = 0; t < threads; ++t) {
+        size_t begin = min(bids.size(), t * chunkSize);
+        size_t end = min(bids.size(), begin + chunkSize);
+        vector<size_t>* heap = &candidates[t];
+        auto selectChunk = [heap, begin, end, k, &rank]() {
+            heap->reserve(k);
+            for (size_t i = begin; i < end; ++i) {
+                offerToHeap(*heap, k, i, rank);
+            }
+        };
+        if (threads == 1) {
+            selectChunk();
+        }
+        else {
+            workers.push_back(thread(selectChunk));
+        }
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+
+    // reduce the per-chunk candidates into the overall best k
+    vector<size_t> best = candidates[0];
+    for (unsigned int t = 1; t < threads; ++t) {
+        for (size_t i = 0; i < candidates[t].size(); ++i) {
+            offerToHeap(best, k, candidates[t][i], rank);
+        }
+    }
+
+    // order the survivors best first
+    sort_heap(best.begin(), best.end(), rank);
+    result.reserve(best.size());
+    for (size_t i = 0; i < best.size(); ++i) {
+        result.push_back(bids[best[i]]);
+    }
+    return result;
+}
+
+//============================================================================
+// Sorted-vector title index
+//============================================================================
+
+// hint the cache to start loading an address we will read soon
+#if defined(_MSC_VER)
+#define PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define PREFETCH(address) __builtin_prefetch(address)
+#endif
+
+/**
+ * Pack the first 8 bytes of a title into an integer that orders the same
+ * way the strings do (big-endian, unsigned bytes, zero padded). Titles
+ * with different packed keys never need a string comparison.
+ */
+uint64_t titleKey(const string& title) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        key <<= 8;
+        if (i < title.size()) {
+            key |= (unsigned char)title[i];
+        }
+    }
+    return key;
+}
+
+/**
+ * Branchless lower bound over packed keys: the loop always runs
+ * log2(n) times and each step is a conditional move rather than an
+ * unpredictable branch. Both possible next probes are prefetched so
+ * the memory latency overlaps with the current comparison.
+ *
+ * @return index of the first key not less than key
+ */
+size_t branchlessLowerBound(const uint64_t* keys, size_t count, uint64_t key) {
+    if (count == 0) {
+        return 0;
+    }
+    const uint64_t* base = keys;
+    size_t n = count;
+    while (n > 1) {
+        size_t half = n / 2;
+        PREFETCH(base + half / 2);
+        PREFETCH(base + half + half / 2);
+        base = (base[half - 1] < key) ? base + half : base;
+        n -= half;
+    }
+    return (base - keys) + (*base < key);
+}
+
+/**
+ * Define a class containing data members and methods to
+ * implement a read-only title index over a vector of bids that is
+ * already sorted by title (quickSort or mergeSort). Lookups are
+ * O(log(n)) with no tree or hash table: a branchless search over packed
+ * 8-byte title keys narrows the range, and full string comparisons are
+ * only made among titles sharing those first 8 bytes.
+ */
+class SortedBidIndex {
+
+private:
+    const vector<Bid>* bids;
+    vector<uint64_t> keys;
+
+public:
+    // a half-open slice of the sorted bids, usable in a range-based for
+    struct BidRange {
+        vector<Bid>::const_iterator first;
+        vector<Bid>::const_iterator last;
+
+        vector<Bid>::const_iterator begin() const { return first; }
+        vector<Bid>::const_iterator end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    SortedBidIndex(const vector<Bid>& sortedBids);
+    size_t LowerBound(const string& title) const;
+    Bid Find(const string& title) const;
+    BidRange Prefix(const string& prefix) const;
+    BidRange Range(const string& fromTitle, const string& toTitle) const;
+};
+
+/**
+ * Build the packed keys for a vector sorted by title, O(n).
+ * The index refers to the vector, so rebuild it after the vector changes.
+ */
+SortedBidIndex::SortedBidIndex(const vector<Bid>& sortedBids) {
+    bids = &sortedBids;
+    keys.reserve(sortedBids.size());
+    for (size_t i = 0; i < sortedBids.size(); ++i) {
+        keys.push_back(titleKey(sortedBids[i].title));
+    }
+}
+
+/**
+ * Position of the first bid whose title is not less than the given title
+ */
+size_t SortedBidIndex::LowerBound(const string& title) const {
+    uint64_t key = titleKey(title);
+
+    // narrow to the titles sharing the first 8 bytes
+    size_t first = branchlessLowerBound(keys.data(), keys.size(), key);
+    size_t last = first;
+    if (key != UINT64_MAX) {
+        last = first + branchlessLowerBound(keys.data() + first, keys.size() - first, key + 1);
+    }
+    else {
+        last = keys.size();
+    }
+
+    // finish with string comparisons inside that (usually tiny) slice
+    size_t lower = first;
+    size_t n = last - first;
+    while (n > 0) {
+        size_t half = n / 2;
+        if ((*bids)[lower + half].title < title) {
+            lower += half + 1;
+            n -= half + 1;
+        }
+        else {
+            n = half;
+        }
+    }
+    return lower;
+}
+
+/**
+ * Find the first bid with exactly the given title
+ *
+ * @return the bid, or an empty bid when no title matches
+ */
+Bid SortedBidIndex::Find(const string& title) const {
+    size_t pos = LowerBound(title);
+    if (pos < bids->size() && (*bids)[pos].title == title) {
+        return (*bids)[pos];
+    }
+    return Bid();
+}
+
+/**
+ * All bids whose title starts with the given prefix, in title order
+ */
+SortedBidIndex::BidRange SortedBidIndex::Prefix(const string& prefix) const {
+    BidRange range;
+    range.first = bids->begin() + LowerBound(prefix);
+    range.last = bids->end();
+
+    // the first string past every title with this prefix: drop trailing
+    // 0xFF bytes and increment the last remaining byte
+    string upper = prefix;
+    while (!upper.empty() && (unsigned char)upper.back() == 0xFF) {
+        upper.pop_back();
+    }
+    if (!upper.empty()) {
+        upper.back() = (char)((unsigned char)upper.back() + 1);
+        range.last = bids->begin() + LowerBound(upper);
+    }
+    return range;
+}
+
+/**
+ * All bids with fromTitle <= title < toTitle, in title order
+ */
+SortedBidIndex::BidRange SortedBidIndex::Range(const string& fromTitle,
+        const string& toTitle) const {
+    BidRange range;
+    range.first = bids->begin() + LowerBound(fromTitle);
+    range.last = bids->begin() + max(LowerBound(toTitle), (size_t)(range.first - bids->begin()));
+    return range;
+}
+
+//============================================================================
+// Sorting benchmark harness
+//============================================================================
+
+// every sort is repeated until it has run this long (or MAX_BENCH_REPS times)
+const double MIN_BENCH_SECONDS = 0.2;
+const int MAX_BENCH_REPS = 10;
+
+// selection sort is O(n^2), larger inputs would run for hours
+const size_t SELECTION_SORT_MAX_BIDS = 20000;
+
+// quickSort's middle pivot is O(n^2) on organ-pipe inputs as well
+const size_t QUICK_SORT_ORGAN_PIPE_MAX_BIDS = 100000;
+
+// fixed seed so every run generates the same synthetic inputs
+const unsigned int BENCH_SEED = 20230601;
+
+// the largest synthetic input by default. 10^8 bids take about 13 GB
+// before any copies, so that scale has to be asked for with --max-scale
+const size_t DEFAULT_BENCH_MAX_SCALE = 10000000;
+
+// files the external sort reads the input from and writes its output to
+const char* BENCH_EXTERNAL_INPUT = "sort_benchmark_input.csv";
+const char* BENCH_EXTERNAL_OUTPUT = "sort_benchmark_sorted.bin";
+
+// the sort implementations the benchmark compares
+enum BenchmarkSort {
+    BENCH_SELECTION_SORT,
+    BENCH_QUICK_SORT,
+    BENCH_MERGE_SORT,
+    BENCH_STD_SORT,
+    BENCH_STD_STABLE_SORT,
+    BENCH_SORT_BIDS_AMOUNT,
+    BENCH_SORT_BIDS_RADIX,
+    BENCH_SORT_BIDS_SIMD,
+    BENCH_STD_SORT_AMOUNT,
+    BENCH_EXTERNAL_SORT,
+    BENCH_SORT_COUNT
+};
+
+const char* BENCH_SORT_NAMES[BENCH_SORT_COUNT] = {
+    "selectionSort",
+    "quickSort",
+    "mergeSort",
+    "std::sort",
+    "std::stable_sort",
+    "sortBids",
+    "sortBids/radix",
+    "sortBids/simd",
+    "std::sort",
+    "externalSortBids"
+};
+
+// the synthetic input shapes
+enum BenchmarkInput {
+    INPUT_RANDOM,
+    INPUT_SORTED,
+    INPUT_REVERSE,
+    INPUT_FEW_UNIQUE,
+    INPUT_ORGAN_PIPE,
+    INPUT_FRACTIONAL,
+    INPUT_COUNT
+};
+
+const char* BENCH_INPUT_NAMES[INPUT_COUNT] = {
+    "random",
+    "sorted",
+    "reverse",
+    "few-unique",
+    "organ-pipe",
+    "fractional"
+};
+
+/**
+ * Define a class reading the CPU's cache-miss counter around a piece of
+ * code. Only Linux exposes it (through perf events); everywhere else,
+ * or when the kernel refuses access, Stop() reports -1.
+ */
+class CacheMissCounter {
+
+private:
+    int fd;
+
+public:
+    CacheMissCounter();
+    virtual ~CacheMissCounter();
+    void Start();
+    long long Stop();
+};
+
+/**
+ * Open the hardware counter for this process, user space only
+ */
+CacheMissCounter::CacheMissCounter() {
+    fd = -1;
+#if defined(__linux__)
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/**
+ * Destructor
+ */
+CacheMissCounter::~CacheMissCounter() {
+#if defined(__linux__)
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+}
+
+/**
+ * Reset the counter and start counting
+ */
+void CacheMissCounter::Start() {
+#if defined(__linux__)
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * Stop counting
+ *
+ * @return cache misses since Start(), or -1 when not available
+ */
+long long CacheMissCounter::Stop() {
+#if defined(__linux__)
+    long long count = 0;
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) {
+            return count;
+        }
+    }
+#endif
+    return -1;
+}
+
+/**
+ * Generate n synthetic bids. Each bid is built from one integer value:
+ * the title is the value zero padded (so titles order like the values),
+ * the amount is the value in cents and the fund cycles through 8 names.
+ * Fractional inputs are random values whose amounts aren't whole cents,
+ * so sortBids has to sort them as raw doubles (wide radix keys).
+ */
+vector<Bid> generateBids(size_t n, BenchmarkInput input, mt19937_64& random) {
+    vector<Bid> bids(n);
+    char title[32];
+    for (size_t i = 0; i < n; ++i) {
+        unsigned long long value = 0;
+        switch (input) {
+        case INPUT_RANDOM:
+            value = random() % (n * 10);
+            break;
+        case INPUT_SORTED:
+            value = i;
+            break;
+        case INPUT_REVERSE:
+            value = n - 1 - i;
+            break;
+        case INPUT_FEW_UNIQUE:
+            value = random() % 16;
+            break;
+        case INPUT_ORGAN_PIPE:
+            value = i < n / 2 ? i : n - 1 - i;
+            break;
+        default:
+            value = random() % (n * 10);
+            break;
+        }
+        snprintf(title, sizeof(title), "Item %012llu", value);
+        bids[i].title = title;
+        bids[i].bidId = to_string(value + 1);
+        bids[i].fund = "Fund " + to_string(value % 8);
+        bids[i].amount = value / 100.0;
+        if (input == INPUT_FRACTIONAL) {
+            bids[i].amount += (random() % 1000 + 1) / 1.0e6;
+        }
+    }
+    return bids;
+}
+
+/**
+ * Write bids as a CSV file with the eBid columns the loaders read, so
+ * the external sort can be benchmarked on the same input
+ *
+ * @return false when the file can't be written
+ */
+bool writeBenchmarkCsv(const string& path, const vector<Bid>& bids) {
+    vector<char> buffer;
+    ofstream out;
+    if (!openBuffered(out, buffer, path, ios::out | ios::trunc)) {
+        return false;
+    }
+    out << setprecision(17);
+    out << "Auction Title,Auction ID,Department,Close Date,Winning Bid,CC Fee,Fee Percent,"
+        << "Auction Fee Subtotal,Fund\n";
+    for (size_t i = 0; i < bids.size(); ++i) {
+        out << bids[i].title << "," << bids[i].bidId << ",,," << bids[i].amount << ",,,,"
+            << bids[i].fund << "\n";
+    }
+    return (bool)out.flush();
+}
+
+/**
+ * Read back every bid in a binary file written by the external sort
+ */
+vector<Bid> readBidFile(const string& path) {
+    vector<Bid> bids;
+    vector<char> buffer;
+    ifstream in;
+    if (openBuffered(in, buffer, path, ios::in | ios::binary)) {
+        Bid bid;
+        while (readBidRecord(in, bid)) {
+            bids.push_back(bid);
+        }
+    }
+    return bids;
+}
+
+/**
+ * The key a benchmarked sort orders on
+ */
+SortKey benchmarkSortKey(BenchmarkSort sort) {
+    if (sort == BENCH_SORT_BIDS_AMOUNT || sort == BENCH_SORT_BIDS_RADIX
+            || sort == BENCH_SORT_BIDS_SIMD || sort == BENCH_STD_SORT_AMOUNT) {
+        return SORT_BY_AMOUNT;
+    }
+    return SORT_BY_TITLE;
+}
+
+/**
+ * Run one of the benchmarked sorts. The external sort reads its input
+ * from BENCH_EXTERNAL_INPUT, not bids, with the default run budget, so
+ * inputs larger than that are spilled and merged.
+ *
+ * @param counters comparison and swap totals, or nullptr for a timed run
+ */
+void runBenchmarkSort(BenchmarkSort sort, vector<Bid>& bids, MergeSortBuffer& buffer,
+        SortCounters* counters) {
+    switch (sort) {
+    case BENCH_SELECTION_SORT:
+        selectionSort(bids, counters);
+        break;
+    case BENCH_QUICK_SORT:
+        quickSort(bids, 0, (int)bids.size() - 1, counters);
+        break;
+    case BENCH_MERGE_SORT:
+        mergeSort(bids, buffer, SORT_BY_TITLE, counters);
+        break;
+    case BENCH_STD_STABLE_SORT:
+        stable_sort(bids.begin(), bids.end(), BidLess(SORT_BY_TITLE, counters));
+        break;
+    case BENCH_SORT_BIDS_AMOUNT:
+        sortBids(bids, buffer, SORT_BY_AMOUNT);
+        break;
+    case BENCH_SORT_BIDS_RADIX:
+        sortBids(bids, buffer, SORT_BY_AMOUNT, NUMERIC_SORT_RADIX);
+        break;
+    case BENCH_SORT_BIDS_SIMD:
+        sortBids(bids, buffer, SORT_BY_AMOUNT, NUMERIC_SORT_SIMD);
+        break;
+    case BENCH_EXTERNAL_SORT:
+        externalSortBids(BENCH_EXTERNAL_INPUT, BENCH_EXTERNAL_OUTPUT, BINARY_FORMAT, SORT_BY_TITLE);
+        break;
+    default:
+        std::sort(bids.begin(), bids.end(), BidLess(benchmarkSortKey(sort), counters));
+        break;
+    }
+}
+
+/**
+ * Time one sort on one input and write a result row.
+ * The sort is repeated on fresh copies of the input until enough time
+ * has passed, then run once more with counters switched on.
+ */
+void benchmarkSort(BenchmarkSort sort, const vector<Bid>& input, const string& dataset,
+        ostream& out, bool json, bool& firstRow) {
+    MergeSortBuffer buffer;
+    CacheMissCounter cacheMisses;
+    double seconds = 0.0;
+    long long misses = 0;
+    int reps = 0;
+    bool sorted = true;
+    bool external = sort == BENCH_EXTERNAL_SORT;
+
+    if (external && !writeBenchmarkCsv(BENCH_EXTERNAL_INPUT, input)) {
+        cerr << "Failed to write " << BENCH_EXTERNAL_INPUT << endl;
+        return;
+    }
+
+    while (reps < MAX_BENCH_REPS && (reps == 0 || seconds < MIN_BENCH_SECONDS)) {
+        vector<Bid> bids;
+        if (!external) {
+            bids = input;
+        }
+
+        cacheMisses.Start();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        runBenchmarkSort(sort, bids, buffer, nullptr);
+        chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+        long long repMisses = cacheMisses.Stop();
+
+        // check the file the external sort wrote, outside the timing
+        if (external) {
+            bids = readBidFile(BENCH_EXTERNAL_OUTPUT);
+            sorted = sorted && bids.size() == input.size();
+        }
+
+        seconds += chrono::duration<double>(stop - start).count();
+        misses = (repMisses < 0 || misses < 0) ? -1 : misses + repMisses;
+        sorted = sorted && is_sorted(bids.begin(), bids.end(), BidLess(benchmarkSortKey(sort)));
+        ++reps;
+    }
+    if (external) {
+        remove(BENCH_EXTERNAL_INPUT);
+        remove(BENCH_EXTERNAL_OUTPUT);
+    }
+
+    // one more run to count comparisons and swaps; sortBids and the
+    // external sort have neither
+    SortCounters counters;
+    if (sort == BENCH_SORT_BIDS_AMOUNT || sort == BENCH_SORT_BIDS_RADIX
+            || sort == BENCH_SORT_BIDS_SIMD || external) {
+        counters.comparisons = -1;
+        counters.swaps = -1;
+    }
+    else {
+        vector<Bid> bids = input;
+        runBenchmarkSort(sort, bids, buffer, &counters);
+        if (sort == BENCH_STD_SORT || sort == BENCH_STD_STABLE_SORT || sort == BENCH_STD_SORT_AMOUNT) {
+            counters.swaps = -1;
+        }
+    }
+
+    double nsPerElement = seconds * 1e9 / reps / max((size_t)1, input.size());
+    long long missesPerRun = misses < 0 ? -1 : misses / reps;
+    const char* key = benchmarkSortKey(sort) == SORT_BY_AMOUNT ? "amount" : "title";
+
+    if (json) {
+        out << (firstRow ? "" : ",\n")
+            << "  {\"dataset\": \"" << dataset << "\", \"n\": " << input.size()
+            << ", \"algorithm\": \"" << BENCH_SORT_NAMES[sort] << "\", \"key\": \"" << key
+            << "\", \"ns_per_element\": " << nsPerElement
+            << ", \"comparisons\": " << counters.comparisons
+            << ", \"swaps\": " << counters.swaps
+            << ", \"cache_misses\": " << missesPerRun
+            << ", \"sorted\": " << (sorted ? "true" : "false") << "}";
+    }
+    else {
+        out << dataset << "," << input.size() << "," << BENCH_SORT_NAMES[sort] << "," << key
+            << "," << nsPerElement << "," << counters.comparisons << "," << counters.swaps
+            << "," << missesPerRun << "," << (sorted ? "true" : "false") << "\n";
+    }
+    out.flush();
+    firstRow = false;
+
+    cout << dataset << " n=" << input.size() << " " << BENCH_SORT_NAMES[sort] << " (" << key
+         << "): " << nsPerElement << " ns/element" << (sorted ? "" : " NOT SORTED") << endl;
+}
+
+/**
+ * Run every sort on the eBid data and on synthetic inputs from 10^3 bids
+ * up to the largest scale (10^7 unless --max-scale says otherwise; pass
+ * --max-scale 1e8 on a machine with enough memory for the 10^8 runs),
+ * writing one CSV or JSON row per run. sortBids is also run with each of
+ * its numeric sorts forced, to show where its automatic choice crosses
+ * over, and the external sort runs on the same inputs from a file.
+ * Comparisons, swaps and cache misses are -1 where they can't be measured.
+ *
+ * usage: VectorSorting --benchmark [--json] [--max-scale N] [--out path] [csvPath]
+ *
+ * @return the process exit code
+ */
+int runSortBenchmark(int argc, char* argv[]) {
+    string csvPath = "eBid_Monthly_Sales.csv";
+    string outPath;
+    size_t maxScale = DEFAULT_BENCH_MAX_SCALE;
+    bool json = false;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        }
+        else if (arg == "--max-scale" && i + 1 < argc) {
+            maxScale = (size_t)atof(argv[++i]);
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else {
+            csvPath = arg;
+        }
+    }
+    if (outPath.empty()) {
+        outPath = json ? "sort_benchmark.json" : "sort_benchmark.csv";
+    }
+
+    ofstream out(outPath, ios::out | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Failed to open " << outPath << endl;
+        return 1;
+    }
+    out << setprecision(6);
+    if (json) {
+        out << "[\n";
+    }
+    else {
+        out << "dataset,n,algorithm,key,ns_per_element,comparisons,swaps,cache_misses,sorted\n";
+    }
+    bool firstRow = true;
+
+    // the real auction data first
+    vector<Bid> ebid = loadBids(csvPath);
+    if (!ebid.empty()) {
+        for (int sort = 0; sort < BENCH_SORT_COUNT; ++sort) {
+            benchmarkSort((BenchmarkSort)sort, ebid, "ebid", out, json, firstRow);
+        }
+    }
+
+    // then every synthetic shape at every scale
+    mt19937_64 random(BENCH_SEED);
+    for (size_t n = 1000; n <= maxScale; n *= 10) {
+        for (int input = 0; input < INPUT_COUNT; ++input) {
+            vector<Bid> bids = generateBids(n, (BenchmarkInput)input, random);
+            for (int sort = 0; sort < BENCH_SORT_COUNT; ++sort) {
+                if (sort == BENCH_SELECTION_SORT && n > SELECTION_SORT_MAX_BIDS) {
+                    continue;
+                }
+                if (sort == BENCH_QUICK_SORT && input == INPUT_ORGAN_PIPE
+                        && n > QUICK_SORT_ORGAN_PIPE_MAX_BIDS) {
+                    continue;
+                }
+                benchmarkSort((BenchmarkSort)sort, bids, BENCH_INPUT_NAMES[input], out, json, firstRow);
+            }
+        }
+    }
+
+    if (json) {
+        out << "\n]\n";
+    }
+    cout << "Results written to " << outPath << endl;
+    return 0;
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional), or --benchmark
+ *               to run the sorting benchmark instead of the menu
+ */
+int main(int argc, char* argv[]) {
+
+    // the benchmark harness takes over the command line
+    if (argc >= 2 && string(argv[1]) == "--benchmark") {
+        return runSortBenchmark(argc, argv);
+    }
+
+    // process command line arguments
+    string csvPath;
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+    }
+
+    // Define a vector to hold all the bids
+    vector<Bid> bids;
+
+    // Define a timer variable
+    clock_t ticks;
+
+    // Where the external sort writes its output
+    string sortedPath = "eBid_Sorted_Bids.csv";
+    long long sortedCount = 0;
+
+    // Highest winning bids selected for the leaderboard
+    const size_t TOP_BIDS_SHOWN = 100;
+    vector<Bid> topBids;
+
+    // Scratch space kept across merge sorts so repeated sorts don't allocate
+    MergeSortBuffer mergeBuffer;
+
+    // Title prefix entered for index lookups
+    string titlePrefix;
+
+    int choice = 0;
+    while (choice != 10) {
+        cout << "Menu:" << endl;
+        cout << "  1. Load Bids" << endl;
+        cout << "  2. Display All Bids" << endl;
+        cout << "  3. Selection Sort All Bids" << endl;
+        cout << "  4. Quick Sort All Bids" << endl;
+        cout << "  5. External Sort Bids to File" << endl;
+        cout << "  6. Display Top Winning Bids" << endl;
+        cout << "  7. Merge Sort All Bids" << endl;
+        cout << "  8. Find Bids by Title Prefix" << endl;
+        cout << "  9. Sort All Bids by Amount" << endl;
+        cout << "  10. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+
+        case 1:
+            // Initialize a timer variable before loading bids
+            ticks = clock();
+
+            // Complete the method call to load the bids
+            bids = loadBids(csvPath);
+
+            cout << bids.size() << " bids read" << endl;
+
+            // Calculate elapsed time and display result
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 2:
+            // Loop and display the bids read
+            for (int i = 0; i < bids.size(); ++i) {
+                displayBid(bids[i]);
+            }
+            cout << endl;
+
+            break;
+
+        // FIXME (1b): Invoke the selection sort and report timing results
+        case 3:
+            //Initialize a timer variable before loading the bids.
+            ticks = clock();
+
+            //Call the SelectionSort method to load the bids;
+            selectionSort(bids);
+
+            //Displays how the size of bids to the screen.
+            cout << bids.size() << " bids sorted" << endl;
+
+            //Calculate the elapsed time and displays the results to the screen.
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+        
+         // FIXME (2b): Invoke the quick sort and report timing results
+        case 4:
+            // Start a timer variable before loading the bids.
+            ticks = clock();
+
+            //Call the QuickSort method to load the bids.
+            quickSort(bids, 0, bids.size() - 1);
+
+            //Displays the size of bids to the screen.
+            cout << bids.size() << " bids sorted" << endl;
+
+            //Calculate the elapsed time and display the results to the screen.
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 5:
+            // Start a timer before streaming the file through the external sort.
+            ticks = clock();
+
+            // Sort the CSV file on disk without loading it into the bids vector.
+            sortedCount = externalSortBids(csvPath, sortedPath);
+
+            if (sortedCount >= 0) {
+                cout << sortedCount << " bids sorted into " << sortedPath << endl;
+            }
+
+            //Calculate the elapsed time and display the results to the screen.
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 6:
+            // Start a timer before selecting the highest winning bids.
+            ticks = clock();
+
+            // Select the highest amounts without reordering the bids vector.
+            topBids = selectTopBids(bids, TOP_BIDS_SHOWN, SORT_BY_AMOUNT);
+
+            //Calculate the elapsed time before the bids are displayed.
+            ticks = clock() - ticks;
+
+            for (size_t i = 0; i < topBids.size(); ++i) {
+                displayBid(topBids[i]);
+            }
+            cout << topBids.size() << " top bids selected" << endl;
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 7:
+            // Start a timer before sorting the bids.
+            ticks = clock();
+
+            // Stable sort on title, reusing the scratch space from earlier sorts.
+            mergeSort(bids, mergeBuffer);
+
+            //Displays the size of bids to the screen.
+            cout << bids.size() << " bids sorted" << endl;
+
+            //Calculate the elapsed time and display the results to the screen.
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 8:
+            // The index only works on bids already sorted by title.
+            if (!is_sorted(bids.begin(), bids.end(), BidLess(SORT_BY_TITLE))) {
+                cout << "Sort the bids by title first." << endl;
+                break;
+            }
+
+            cout << "Enter title prefix: ";
+            cin.ignore();
+            getline(cin, titlePrefix);
+
+            // Start a timer before building the index and running the query.
+            ticks = clock();
+
+            {
+                SortedBidIndex titleIndex(bids);
+                SortedBidIndex::BidRange matches = titleIndex.Prefix(titlePrefix);
+
+                //Calculate the elapsed time before the bids are displayed.
+                ticks = clock() - ticks;
+
+                for (const Bid& match : matches) {
+                    displayBid(match);
+                }
+                cout << matches.size() << " bids found" << endl;
+            }
+
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 9:
+            // Start a timer before sorting the bids.
+            ticks = clock();
+
+            // Numeric keys take the radix or SIMD path.
+            sortBids(bids, mergeBuffer, SORT_BY_AMOUNT);
+
+            //Displays the size of bids to the screen.
+            cout << bids.size() << " bids sorted" << endl;
+
+            //Calculate the elapsed time and display the results to the screen.
+            ticks = clock() - ticks;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
         }
     }
 